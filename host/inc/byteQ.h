@@ -0,0 +1,133 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef BYTEQ_H_
+#define BYTEQ_H_
+
+/**
+ * A stand-in for the firmware byte queue, so that the library builds and runs on a host
+ * Only the parts used by the blueberry sources are provided. One byte of the buffer is always left empty,
+ * so that a full queue can be told apart from an empty one
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * A circular queue of bytes. Bytes are added at the back and removed from the front
+ */
+typedef struct {
+	uint8_t* buffer;
+	uint32_t bufferSize;
+	volatile uint32_t front;//the index of the oldest byte
+	volatile uint32_t back;//the index of the next byte to be added
+} ByteQ;
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * sets up an empty queue in the specified buffer
+ * @param q - the queue
+ * @param buffer - the memory for the bytes
+ * @param size - the number of bytes of buffer
+ */
+static inline void initByteQ(ByteQ* q, uint8_t* buffer, uint32_t size){
+	q->buffer = buffer;
+	q->bufferSize = size;
+	q->front = 0;
+	q->back = 0;
+}
+
+/**
+ * gets the number of bytes in the queue
+ */
+static inline uint32_t getBytesUsed(ByteQ* q){
+	return (q->back + q->bufferSize - q->front) % q->bufferSize;
+}
+
+/**
+ * gets the number of bytes that can be added to the queue
+ */
+static inline uint32_t getBytesFree(ByteQ* q){
+	return q->bufferSize - 1 - getBytesUsed(q);
+}
+
+/**
+ * tests if there are any bytes in the queue
+ */
+static inline bool isByteQNotEmpty(ByteQ* q){
+	return q->front != q->back;
+}
+
+/**
+ * removes bytes from the front of the queue without reading them
+ * @param q - the queue
+ * @param n - the number of bytes to remove. This must not be more than are in the queue
+ */
+static inline void discardFromByteQ(ByteQ* q, uint32_t n){
+	q->front = (q->front + n) % q->bufferSize;
+}
+
+/**
+ * adds bytes that were written in place past the back of the queue
+ * @param q - the queue
+ * @param n - the number of bytes to add. This must not be more than getBytesFree()
+ */
+static inline void advanceByteQBack(ByteQ* q, uint32_t n){
+	q->back = (q->back + n) % q->bufferSize;
+}
+
+/**
+ * copies bytes onto the back of the queue
+ * @param q - the queue
+ * @param src - the bytes to add
+ * @param n - the number of bytes to add
+ * @return the number of bytes added, which is less than n if the queue filled up
+ */
+static inline uint32_t addBytesToByteQ(ByteQ* q, const uint8_t* src, uint32_t n){
+	uint32_t m = getBytesFree(q);
+	if(n > m){
+		n = m;
+	}
+	for(uint32_t i = 0; i < n; ++i){
+		q->buffer[(q->back + i) % q->bufferSize] = src[i];
+	}
+	advanceByteQBack(q, n);
+	return n;
+}
+
+#endif /* BYTEQ_H_ */
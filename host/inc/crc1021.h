@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef CRC1021_H_
+#define CRC1021_H_
+
+/**
+ * A stand-in for the firmware CRC unit, so that the library builds and runs on a host
+ * This is the CRC-16 with polynomial 0x1021 and a starting value of 0xffff, fed one 32-bit word at a time,
+ * most significant bit first, as a CRC peripheral does
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * starts a new crc
+ * @param crc - the crc to reset
+ */
+static inline void resetCrc1021P(uint16_t* crc){
+	*crc = 0xffff;
+}
+
+/**
+ * folds one word into the crc
+ * @param crc - the running crc
+ * @param w - the word, which is taken most significant bit first
+ */
+static inline void crc1021P32(uint16_t* crc, uint32_t w){
+	uint32_t c = *crc;
+	for(uint32_t i = 0; i < 32; ++i){
+		uint32_t top = ((c >> 15) ^ (w >> 31)) & 1;
+		c = (c << 1) & 0xffff;
+		if(top){
+			c ^= 0x1021;
+		}
+		w <<= 1;
+	}
+	*crc = (uint16_t)c;
+}
+
+/**
+ * finishes the crc. There is nothing left to do for this CRC, so the running crc is the result
+ * @param crc - the running crc, which becomes the result
+ */
+static inline void getCrc1021P(uint16_t* crc){
+	(void)crc;
+}
+
+#endif /* CRC1021_H_ */
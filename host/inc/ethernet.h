@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef ETHERNET_H_
+#define ETHERNET_H_
+
+/**
+ * A stand-in for the UDP hooks of the firmware network stack, so that the library builds on a host
+ * On Linux these are provided by blueberry-udp-host.c. Elsewhere host/src/ethernet.c provides ones that do nothing
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * A function to process a received UDP datagram
+ * @param sourceMac - the mac address of the sender
+ * @param sourceIp - the IP address of the sender
+ * @param sourcePort - the port the datagram was sent from
+ * @param destIp - the IP address the datagram was sent to
+ * @param destPort - the port the datagram was sent to
+ * @param data - the payload
+ * @param dataLength - the number of bytes of payload
+ */
+typedef bool (*UdpPacketProcessor)(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t sourcePort, uint32_t destIp, uint16_t destPort, uint8_t* data, uint32_t dataLength);
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * calls the processor for every datagram received on the specified port
+ */
+void registerUdpListener(uint16_t port, UdpPacketProcessor p, bool b);
+
+/**
+ * sets up the ethernet port
+ */
+void setEthernetPort(uint16_t a, uint16_t b);
+
+/**
+ * gets a buffer to build a UDP datagram in
+ */
+uint8_t* startUdpPacket(uint8_t mac[6], uint32_t ip, uint16_t port, uint16_t srcPort, uint32_t* maxSize);
+
+/**
+ * sends a datagram built in a buffer from startUdpPacket()
+ */
+void completeUdpPacket(uint8_t* data, uint32_t len, bool b);
+
+#endif /* ETHERNET_H_ */
@@ -0,0 +1,85 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+/**
+ * A stand-in for the firmware queue index helpers, so that code using them builds on a host
+ * A queue is an array of n items with front and back indices. One item is always left empty
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * moves the back of the queue on after an item was written there. If the queue was full then the oldest item is dropped
+ * @param front - the index of the oldest item
+ * @param back - the index of the next item to add
+ * @param n - the number of items in the array
+ */
+static inline void justAddedToQueueBack(uint32_t* front, uint32_t* back, uint32_t n){
+	*back = (*back + 1) % n;
+	if(*back == *front){
+		*front = (*front + 1) % n;
+	}
+}
+
+/**
+ * moves the front of the queue on after the oldest item was used
+ * @param front - the index of the oldest item
+ * @param back - the index of the next item to add
+ * @param n - the number of items in the array
+ */
+static inline void doneWithQueueFront(uint32_t* front, uint32_t* back, uint32_t n){
+	if(*front != *back){
+		*front = (*front + 1) % n;
+	}
+}
+
+/**
+ * tests if there are any items in the queue
+ */
+static inline bool isQueueNotEmpty(uint32_t* front, uint32_t* back){
+	return *front != *back;
+}
+
+#endif /* QUEUE_H_ */
@@ -0,0 +1,68 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef TIMESYNC_H_
+#define TIMESYNC_H_
+
+/**
+ * A stand-in for the firmware time functions, so that the library builds and runs on a host
+ * The times come from the monotonic clock of the host
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * gets the time in milliseconds. This wraps
+ */
+uint32_t getLocalTimeMillis(void);
+
+/**
+ * gets the time in microseconds. This wraps
+ */
+uint32_t getTimeInMicroSeconds(void);
+
+/**
+ * tests if more than the specified time has passed since the timer was last set, and sets it again if so
+ */
+bool slowTimer(uint32_t* t, uint32_t microseconds);
+
+#endif /* TIMESYNC_H_ */
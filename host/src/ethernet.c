@@ -0,0 +1,90 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <ethernet.h>
+
+#include <stddef.h>
+
+//on Linux these are provided by blueberry-udp-host.c
+#if !defined(__linux__)
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+/**
+ * There is no network on this host, so nothing is ever received
+ */
+void registerUdpListener(uint16_t port, UdpPacketProcessor p, bool b){
+	(void)port;
+	(void)p;
+	(void)b;
+}
+
+/**
+ * There is no network on this host, so this does nothing
+ */
+void setEthernetPort(uint16_t a, uint16_t b){
+	(void)a;
+	(void)b;
+}
+
+/**
+ * There is no network on this host, so there is never a buffer
+ */
+uint8_t* startUdpPacket(uint8_t mac[6], uint32_t ip, uint16_t port, uint16_t srcPort, uint32_t* maxSize){
+	(void)mac;
+	(void)ip;
+	(void)port;
+	(void)srcPort;
+	*maxSize = 0;
+	return NULL;
+}
+
+/**
+ * There is no network on this host, so this does nothing
+ */
+void completeUdpPacket(uint8_t* data, uint32_t len, bool b){
+	(void)data;
+	(void)len;
+	(void)b;
+}
+
+#endif //!__linux__
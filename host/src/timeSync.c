@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#if !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L//for clock_gettime(). This must come before any system header
+#endif
+#include <timeSync.h>
+
+#include <time.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static uint64_t getMicroSeconds(void);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+/**
+ * gets the time in milliseconds. This wraps
+ */
+uint32_t getLocalTimeMillis(void){
+	return (uint32_t)(getMicroSeconds() / 1000);
+}
+
+/**
+ * gets the time in microseconds. This wraps
+ */
+uint32_t getTimeInMicroSeconds(void){
+	return (uint32_t)getMicroSeconds();
+}
+
+/**
+ * tests if more than the specified time has passed since the timer was last set, and sets it again if so
+ * @param t - the time the timer was last set, in microseconds
+ * @param microseconds - the period of the timer
+ * @return true if the time has passed
+ */
+bool slowTimer(uint32_t* t, uint32_t microseconds){
+	uint32_t now = getTimeInMicroSeconds();
+	if(now - *t > microseconds){
+		*t = now;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * gets the time from the monotonic clock of the host
+ * @return the time in microseconds
+ */
+static uint64_t getMicroSeconds(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000u + (uint64_t)ts.tv_nsec/1000u;
+}
@@ -0,0 +1,87 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef INC_BLUEBERRY_CRC_H_
+#define INC_BLUEBERRY_CRC_H_
+
+/**
+ * A module to compute the packet CRC over contiguous spans of bytes
+ * The result is always the same as feeding each word to crc1021P32() in turn.
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+/**
+ * Selects the CRC engine at build time
+ * 0 - table-free, one call to crc1021P32() per word. Uses no RAM. Best for small MCUs
+ * 4 - slice-by-4 tables, one word per step. Uses 3 kB of constant tables, which can stay in flash
+ * 8 - slice-by-8 tables, two words per step. Uses 6 kB of constant tables, which can stay in flash
+ */
+#ifndef BB_CRC_SLICES
+#define BB_CRC_SLICES (0)
+#endif
+
+/**
+ * Set to 1 on host builds to add a carry-less multiply (PCLMULQDQ) path for long spans on x86-64
+ * It is only used if the CPU supports it and it agrees with crc1021P32() when checked at init,
+ * otherwise the engine selected by BB_CRC_SLICES is used
+ */
+#ifndef BB_CRC_CLMUL
+#define BB_CRC_CLMUL (0)
+#endif
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * prepares the CRC engine. This checks the tables against crc1021P32() if the engine uses them.
+ * Call it once before any thread or interrupt that computes a CRC starts. initBbParser() calls it
+ */
+void initBbCrc(void);
+
+/**
+ * folds the specified number of words of a contiguous span into a running CRC
+ * @param crc - the running crc, as used by crc1021P32()
+ * @param data - the first byte of the span. This does not need to be aligned
+ * @param wordNum - the number of 4-byte words to process
+ * @return the updated crc
+ */
+uint16_t updateBbCrc(uint16_t crc, const uint8_t* data, uint32_t wordNum);
+
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+
+#endif /* INC_BLUEBERRY_CRC_H_ */
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef INC_BLUEBERRY_LINK_H_
+#define INC_BLUEBERRY_LINK_H_
+
+/**
+ * The health counters of each receive link. These are always kept, and are read with getBbLinkCounts()
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdatomic.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * The health counters of a receive link. These only ever count up, so compare snapshots to see what changed
+ * Each counter has a single writer, so they are updated without locks or read-modify-write instructions
+ * and can be read from anywhere with getBbLinkCounts().
+ * rxOverflows is written by recordBbLinkOverflow(), from the code that fills the receive queue, such as the receive interrupt.
+ * All the others are written by the receive path of the link
+ */
+typedef struct {
+	atomic_uint_fast32_t packets;//the number of good packets received
+	atomic_uint_fast32_t bytesDiscarded;//the number of received bytes thrown away because they weren't part of a good packet
+	atomic_uint_fast32_t preambleMisses;//the number of times the bytes didn't start with a preamble
+	atomic_uint_fast32_t crcFailures;//the number of packets with a bad CRC
+	atomic_uint_fast32_t truncatedPackets;//the number of packets shorter than their header says
+	atomic_uint_fast32_t oversizePackets;//the number of packets too big to ever fit in the receive buffer
+	atomic_uint_fast32_t rxOverflows;//the number of times received bytes were dropped because the receive queue was full
+	atomic_uint_fast32_t txOverflows;//the number of responses that were cut short because the send queue was full
+} BbLinkStats;
+
+/**
+ * A snapshot of the health counters of a receive link, as got with getBbLinkCounts()
+ */
+typedef struct {
+	uint32_t packets;
+	uint32_t bytesDiscarded;
+	uint32_t preambleMisses;
+	uint32_t crcFailures;
+	uint32_t truncatedPackets;
+	uint32_t oversizePackets;
+	uint32_t rxOverflows;
+	uint32_t txOverflows;
+} BbLinkCounts;
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+
+#endif /* INC_BLUEBERRY_LINK_H_ */
@@ -72,7 +72,7 @@ uint32_t getBbMessageLength(Bb* bb, BbBlock msg);
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  * @param sequenceElement - the index of the sequence element. This must be smaller than the sequence length - but this is not checked here.
  */
-BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t sequenceElement);
+BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, BbBlock i, uint32_t sequenceElement);
 /**
  * Gets the length of the specified sequence.
  * This can be used to read or write from the specified sequence element
@@ -80,7 +80,21 @@ BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t seq
  * @param msg - the index of the beginning of the message
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  */
-uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, uint16_t i);
+uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, BbBlock i);
+/**
+ * Checks that the block of the specified sequence is empty or lies entirely within the message
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ */
+bool checkBbSequenceBlock(Bb* buf, BbBlock msg, BbBlock i);
+/**
+ * Checks that the block of the specified string is empty or lies entirely within the message
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the string placeholder
+ */
+bool checkBbStringBlock(Bb* buf, BbBlock msg, BbBlock i);
 /**
  * Initializes the sequence placeholder and sequence length with the required information
  * @param buf - the buffer containing the data packet, message, etc.
@@ -91,7 +105,7 @@ uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, uint16_t i);
  * @return the block in the buffer containing the sequence data
 
  */
-BbBlock initBbSequence(Bb* buf, BbBlock msg, uint16_t i, uint32_t elementByteNum, uint32_t elementNum);
+BbBlock initBbSequence(Bb* buf, BbBlock msg, BbBlock i, uint32_t elementByteNum, uint32_t elementNum);
 
 
 /**
@@ -102,7 +116,7 @@ BbBlock initBbSequence(Bb* buf, BbBlock msg, uint16_t i, uint32_t elementByteNum
  * @param arrayElement - the item of the array that we want
  * @param arrayElementLength - the length in bytes of each array element
  */
-BbBlock getBbArrayElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t arrayElement, uint32_t arrayElementLength);
+BbBlock getBbArrayElementIndex(Bb* buf, BbBlock msg, BbBlock i, uint32_t arrayElement, uint32_t arrayElementLength);
 
 /**
  * Checks to see if this message contains data
@@ -119,7 +133,77 @@ bool isBbMessageEmpty(Bb* buf, BbBlock msg);
  * @param msg - the index of the beginning of the message
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  */
-uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, uint16_t i);
+uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, BbBlock i);
+
+/**
+ * copies n 8-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceUint8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint8_t* dest, uint32_t n);
+
+/**
+ * copies n 8-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceUint8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint8_t* src, uint32_t n);
+
+/**
+ * copies n 8-bit, signed integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceInt8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int8_t* dest, uint32_t n);
+
+/**
+ * copies n 8-bit, signed integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceInt8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int8_t* src, uint32_t n);
+
+/**
+ * copies n 16-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceUint16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint16_t* dest, uint32_t n);
+
+/**
+ * copies n 16-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceUint16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint16_t* src, uint32_t n);
+
+/**
+ * copies n 16-bit, signed integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceInt16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int16_t* dest, uint32_t n);
+
+/**
+ * copies n 16-bit, signed integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceInt16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int16_t* src, uint32_t n);
+
+/**
+ * copies n 32-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceUint32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint32_t* dest, uint32_t n);
+
+/**
+ * copies n 32-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceUint32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint32_t* src, uint32_t n);
+
+/**
+ * copies n 32-bit, signed integers from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceInt32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int32_t* dest, uint32_t n);
+
+/**
+ * copies n 32-bit, signed integers from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceInt32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int32_t* src, uint32_t n);
+
+/**
+ * copies n 32-bit, floating point values from the specified sequence to memory, starting at the specified element
+ */
+uint32_t getBbSequenceFloat32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, float* dest, uint32_t n);
+
+/**
+ * copies n 32-bit, floating point values from memory to the specified sequence, starting at the specified element
+ */
+uint32_t setBbSequenceFloat32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const float* src, uint32_t n);
 
 
 /**
@@ -131,7 +215,7 @@ uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, uint16_t i);
  * @param n - the maximum number of characters to copy.
  * @return the number of characters copied
  */
-uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, uint16_t i, char* dest, uint32_t n);
+uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, BbBlock i, char* dest, uint32_t n);
 
 /**
  * copies a string from the specified memory location to the message
@@ -143,7 +227,7 @@ uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, uint16_t i, char* dest, u
  * @param n - the maximum number of characters to copy.
  * @return the number of characters copied
  */
-uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, uint16_t i, char* src, uint32_t n);
+uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, BbBlock i, char* src, uint32_t n);
 
 //*******************************************************************************************
 //Code
@@ -35,9 +35,40 @@ THE SOFTWARE.
 //Includes
 //*******************************************************************************************
 #include <blueberry-transcoder.h>
+#include <blueberry-stats.h>
+#include <blueberry-link.h>
 //*******************************************************************************************
 //Defines
 //*******************************************************************************************
+#ifndef PROCESSOR_NUM
+#define PROCESSOR_NUM (100)//the number of processors that can be registered at runtime. Past 255 the dispatch pages take twice the space
+#endif
+//the number of entries of a constant builder table that can be requested with queueBbMessage(). A longer table is cut short
+//each one needs a pending slot in every BbContext, the same as a registered builder, which is about 8 bytes with packing
+#ifndef BUILDER_TABLE_NUM
+#define BUILDER_TABLE_NUM (64)
+#endif
+#define PENDING_NUM (PROCESSOR_NUM + BUILDER_TABLE_NUM)//one pending slot for every builder
+
+//the number of queued messages that can be packed into as few packets as possible, using the builder size hints
+//more than this are built in the order they were requested. Set to 0 to leave out packing, and the size hints with it
+#ifndef PACK_NUM
+#define PACK_NUM (PENDING_NUM)
+#endif
+
+//the dispatch index looks up keys directly when the module and message fit in these ranges
+//it takes DISPATCH_MODULE_NUM + DISPATCH_PAGE_NUM * DISPATCH_PAGE_SIZE bytes for the parsers and again for the builders,
+//1.25 kB each as set here, with two bytes per page entry if PROCESSOR_NUM is over 255
+//Set DISPATCH_PAGE_NUM to 0 to leave it out, and every key is found by the binary search
+#ifndef DISPATCH_MODULE_NUM
+#define DISPATCH_MODULE_NUM (256)//module IDs below this are looked up directly. At most 256
+#endif
+#ifndef DISPATCH_PAGE_NUM
+#define DISPATCH_PAGE_NUM (16)//the number of modules that can have a message page. Less than 255
+#endif
+#ifndef DISPATCH_PAGE_SIZE
+#define DISPATCH_PAGE_SIZE (64)//message IDs below this are looked up directly
+#endif
 
 //*******************************************************************************************
 //Types
@@ -50,6 +81,155 @@ THE SOFTWARE.
  */
 typedef void (*BbProcessor)(Bb* bb, BbBlock msg);
 
+/**
+ * A function pointer prototype for handing off a finished packet of a multi-packet response
+ * The function should send the packet, then set up the buffer for the next packet, with a length of zero
+ * @param bb - the buffer containing the finished packet
+ * @param context - whatever was passed to makeBbPacketsWithQueuedMessages()
+ * @return true if a new buffer was set up, false if building should stop
+ */
+typedef bool (*BbNextBuffer)(Bb* bb, void* context);
+
+/**
+ * A function pointer prototype for estimating the variable part of a message before it is built
+ * This is the space needed by the message's sequences and strings, which depends on the data at the time
+ * @param key - the module/message key of the message
+ * @return the number of bytes the variable part of the message will take
+ */
+typedef uint32_t (*BbSizeHint)(uint32_t key);
+
+/**
+ * An entry of a constant table of processors, as emitted by the autogenerated code
+ * A table of these must be sorted by key, and can be declared const so that it lives in flash
+ * The size hint is only used for builders, and can be left out, in which case the builder's size is unknown
+ */
+typedef struct {
+	uint32_t key;//the module/message key
+	BbProcessor processor;//the parser or builder for this key
+	uint32_t fixedLength;//the number of bytes of the message that don't depend on the data, including the header. 0 if unknown
+	BbSizeHint variableLength;//estimates the rest of the message, or NULL if there isn't any
+} BbProcessorEntry;
+
+/**
+ * The layout of one message, as emitted by the autogenerated code, for validateBbPacket()
+ * A table of these must be sorted by key, and can be declared const so that it lives in flash
+ */
+typedef struct {
+	uint32_t key;//the module/message key
+	uint8_t maxOrdinal;//the ordinal of the last field of the message
+	uint16_t fixedLength;//the number of bytes of the message that don't depend on the data, including the header
+	const uint16_t* sequences;//the indices of the sequence placeholders in the message
+	uint16_t sequenceNum;
+	const uint16_t* strings;//the indices of the string placeholders in the message
+	uint16_t stringNum;
+} BbMessageLayout;
+
+/**
+ * A view of one message of a received packet, as got with nextBbMessage()
+ * The message is not copied, so use the accessors with msg to read its fields
+ */
+typedef struct {
+	uint32_t key;//the module/message key
+	BbBlock msg;//the index of the start of the message in the packet
+	uint32_t length;//the length of the message in bytes, including its header
+	uint8_t maxOrdinal;//the ordinal of the last field of the message
+} BbMessageView;
+
+/**
+ * The state of a walk through the messages of a received packet, as started with startBbMessageIterator()
+ */
+typedef struct {
+	Bb* bb;
+	uint32_t next;//the index of the next message
+	uint32_t end;//the index just past the last message
+} BbMessageIterator;
+
+/**
+ * The slot of a pending builder, as small as PENDING_NUM allows. This is only public so that a BbContext can be declared
+ */
+#if PENDING_NUM <= 256
+typedef uint8_t BbPendingSlot;
+#else
+typedef uint16_t BbPendingSlot;
+#endif
+
+/**
+ * An entry of a dispatch page: the index of a registered processor plus one, as small as PROCESSOR_NUM allows.
+ * This is only public so that a BbContext can be declared
+ */
+#if PROCESSOR_NUM <= 255
+typedef uint8_t BbDispatchSlot;
+#else
+typedef uint16_t BbDispatchSlot;
+#endif
+
+/**
+ * A registered processor. This is only public so that a BbContext can be declared
+ */
+typedef struct {
+	uint32_t key;
+	BbProcessor parser;
+} BbProcessorKeyValue;
+
+/**
+ * The size hint of a registered builder, see setBbBuilderSizeHint(). This is only public so that a BbContext can be declared
+ */
+typedef struct {
+	uint32_t fixedLength;
+	BbSizeHint variableLength;
+} BbSizeHintValue;
+
+/**
+ * The processors of one kind, parsers or builders, with their index. This is only public so that a BbContext can be declared
+ */
+typedef struct {
+	BbProcessorKeyValue m_processors[PROCESSOR_NUM];
+	uint32_t num;
+#if DISPATCH_PAGE_NUM != 0
+	//a two level module->message index into m_processors, rebuilt on registration
+	uint8_t pageOfModule[DISPATCH_MODULE_NUM];//the page for each module plus one, zero if the module has no processors
+	BbDispatchSlot pages[DISPATCH_PAGE_NUM][DISPATCH_PAGE_SIZE];//the index of each message's processor plus one, zero if none
+	uint32_t pageNum;
+#endif
+	const BbProcessorEntry* table;//a constant table of processors, sorted by key, searched after the registered ones
+	uint32_t tableNum;
+} BbProcessors;
+
+/**
+ * The state of one blueberry endpoint: its dispatch tables, the messages requested for its next response and its timing
+ * The functions that don't take a context use a default one, set up by initBbParser(). These include
+ * transceiveBrPacketN(), processBlueberryPacket(), queueBbMessage() and the register functions, so they all share one
+ * set of parsers, builders and pending messages, and only one thread may use them.
+ * Contexts share no other state, so independent endpoints can run on different threads. Set one up with initBbContext()
+ * The CRC tables and the list of open rings are shared, but are only written at init: call initBbParser() or initBbCrc()
+ * and open any rings before the threads start
+ */
+typedef struct {
+	BbProcessors parsers;
+	BbProcessors builders;
+	//the builders requested for the next packet, as slots of builders (see findProcessorSlot())
+	//each builder can be pending at most once, so the queue can't overflow
+	uint32_t pendingBits[(PENDING_NUM + 31) / 32];//a bit for each slot that is already queued
+	BbPendingSlot pendingQ[PENDING_NUM];//the queued slots, in the order they were requested
+	uint32_t pendingFront;
+	uint32_t pendingNum;
+#if PACK_NUM != 0
+	BbSizeHintValue hints[PROCESSOR_NUM];//the size hint of each registered builder, in the same order as builders
+	//scratch space for packing the pending builders into packets
+	BbPendingSlot packSlot[PACK_NUM];//the pending slots, in the order they'll be built
+	uint16_t packSize[PACK_NUM];//the estimated size of each, 0 if unknown
+	uint16_t packBin[PACK_NUM];//the packet each is assigned to
+	uint16_t packFree[PACK_NUM];//the space left in each packet
+#endif
+	const BbMessageLayout* layouts;//the layouts of the messages, sorted by key, for validating received packets
+	uint32_t layoutNum;
+	uint32_t lastRxTime;//when the last packet addressed to this endpoint was received, in microseconds
+	BbLinkStats link;//the health of the link this context receives from
+#if BB_STATS
+	BbStats stats;//how often and how long each message is parsed and built
+#endif
+} BbContext;
+
 
 //*******************************************************************************************
 //Variables
@@ -63,6 +243,41 @@ typedef void (*BbProcessor)(Bb* bb, BbBlock msg);
  * processes a blueberry packet and parses each message
  */
 void parseBbPacket(Bb* buf);
+
+/**
+ * starts a walk through the messages of a received packet, without any lookup or copying
+ */
+void startBbMessageIterator(BbMessageIterator* it, Bb* bb);
+
+/**
+ * gets the next message of the packet
+ */
+bool nextBbMessage(BbMessageIterator* it, BbMessageView* view);
+
+/**
+ * checks the header of every message of a received packet in one pass
+ */
+bool validateBbMessageHeaders(Bb* bb, uint32_t* messageNum);
+
+/**
+ * sets a constant table of message layouts, sorted by key, so that received packets are validated before they are parsed
+ */
+void setBbLayoutTable(const BbMessageLayout* table, uint32_t num);
+
+/**
+ * sets a constant table of message layouts, sorted by key, in the specified context
+ */
+void setBbLayoutTableCtx(BbContext* ctx, const BbMessageLayout* table, uint32_t num);
+
+/**
+ * checks every message of a received packet against its layout in one pass, and marks the packet as verified if they are all good
+ */
+bool validateBbPacket(Bb* bb);
+
+/**
+ * checks every message of a received packet against its layout in the specified context
+ */
+bool validateBbPacketCtx(BbContext* ctx, Bb* bb);
 /**
  * registers a parser for a given message
  */
@@ -73,24 +288,153 @@ void registerBbParser(uint32_t moduleMessageKey, BbProcessor parser);
  */
 void registerBbBuilder(uint32_t moduleMessageKey, BbProcessor builder);
 
+/**
+ * gives the size of the message made by a registered builder, so that queued messages can be packed into as few packets as possible
+ */
+void setBbBuilderSizeHint(uint32_t moduleMessageKey, uint32_t fixedLength, BbSizeHint variableLength);
+
+/**
+ * sets a constant table of parsers, sorted by key. This needs no registration and uses no RAM.
+ * Parsers registered with registerBbParser() take precedence over the table
+ */
+void setBbParserTable(const BbProcessorEntry* table, uint32_t num);
+
+/**
+ * sets a constant table of builders, sorted by key. This needs no registration, and the table itself uses no RAM.
+ * Builders registered with registerBbBuilder() take precedence over the table
+ * Only the first BUILDER_TABLE_NUM entries are used, as each of those takes a pending slot in RAM
+ * @return false if the table was longer than BUILDER_TABLE_NUM, and so was cut short
+ */
+bool setBbBuilderTable(const BbProcessorEntry* table, uint32_t num);
+
 /**
  * Must be called at init
  */
 void initBbParser(void);
 
+/**
+ * sets up a context for an independent blueberry endpoint, with no parsers or builders and nothing queued
+ */
+void initBbContext(BbContext* ctx);
+
+/**
+ * gets the context used by the functions that don't take one
+ */
+BbContext* getBbDefaultContext(void);
+
+#if BB_STATS
+/**
+ * gets the parse and build counts of the specified context
+ */
+BbStats* getBbStats(BbContext* ctx);
+
+/**
+ * builds a message containing the counts of the default context. Register this as the builder for BB_STATS_MESSAGE_KEY
+ */
+void buildBbDefaultStatsMessage(Bb* bb, BbBlock msg);
+#endif
+
+/**
+ * processes a blueberry packet and parses each message with the parsers of the specified context
+ */
+void parseBbPacketCtx(BbContext* ctx, Bb* buf);
+
+/**
+ * registers a parser for a given message in the specified context
+ */
+void registerBbParserCtx(BbContext* ctx, uint32_t moduleMessageKey, BbProcessor parser);
+
+/**
+ * register a message processor for adding a message to a buffer in the specified context
+ */
+void registerBbBuilderCtx(BbContext* ctx, uint32_t moduleMessageKey, BbProcessor builder);
+
+/**
+ * gives the size of the message made by a builder registered in the specified context
+ */
+void setBbBuilderSizeHintCtx(BbContext* ctx, uint32_t moduleMessageKey, uint32_t fixedLength, BbSizeHint variableLength);
+
+/**
+ * sets a constant table of parsers, sorted by key, in the specified context
+ */
+void setBbParserTableCtx(BbContext* ctx, const BbProcessorEntry* table, uint32_t num);
+
+/**
+ * sets a constant table of builders, sorted by key, in the specified context
+ */
+bool setBbBuilderTableCtx(BbContext* ctx, const BbProcessorEntry* table, uint32_t num);
+
+/**
+ * indicates that messages were received by the specified context and should trigger a packet of messages to be sent
+ */
+bool isBbPacketRequestedCtx(BbContext* ctx);
+
+/**
+ * requests that the next packet made with the specified context should have the message with the specified key added.
+ */
+void queueBbMessageCtx(BbContext* ctx, uint32_t key);
+
+/**
+ * Make a packet in the specified buffer that contains all messages queued in the specified context
+ */
+void makeBbPacketWithQueuedMessagesCtx(BbContext* ctx, Bb* bb);
+
+/**
+ * Make a packet in the specified buffer that contains the queued messages, taking at most n bytes
+ * Messages that don't fit are left queued for the next packet, so this is only for a link with one peer, such as a UART
+ */
+void makeBbPacketWithQueuedMessagesN(Bb* bb, uint32_t n);
+
+/**
+ * Make a packet in the specified buffer that contains the messages queued in the specified context, taking at most n bytes
+ */
+void makeBbPacketWithQueuedMessagesNCtx(BbContext* ctx, Bb* bb, uint32_t n);
+
+/**
+ * Make as many packets as needed to hold all messages queued in the specified context
+ */
+uint32_t makeBbPacketsWithQueuedMessagesCtx(BbContext* ctx, Bb* bb, BbNextBuffer next, void* context);
+
 /**
  * a function to test the start word of the packet. It will check only up to the Bb.length. It should return true so long as the start word is good
  */
 bool checkBbPreamble(Bb* bb);
+/**
+ * finds the next place in the received bytes, at or after the specified index, where a packet could start
+ */
+uint32_t findBbPreamble(Bb* bb, uint32_t from);
 /**
  * a function to test the length of the received packet so far. It should return true when enough bytes have been received
  */
 bool checkBbLength(Bb* bb);
+/**
+ * gets the length of the packet in bytes, as recorded in the packet header
+ */
+uint32_t getBbPacketLength(Bb* bb);
+/**
+ * tests if the packet stores its sequence and string offsets in words, so that they can reach past 64KB
+ */
+bool isBbPacketLarge(Bb* bb);
 /**
  * a function to check the CRC of the received bytes. It will return true with a correct match
  */
 bool checkBbCrc(Bb* bb);
 
+/**
+ * resets the running crc that is kept while a packet is being received
+ */
+void resetBbRunningCrc(Bb* bb);
+
+/**
+ * folds any whole words received since the last call into the running crc
+ */
+void updateBbRunningCrc(Bb* bb);
+
+/**
+ * a function to check the running CRC of the received bytes. It will return true with a correct match
+ */
+bool checkBbRunningCrc(Bb* bb);
+
 /**
  * does any preliminary header setup and computes the locationo for the starting message
  */
@@ -120,6 +464,7 @@ bool minBbLengthCheck(Bb* bb);
 bool isBbPacketRequested();
 /**
  * requests that the next packet should have the message with the specified key added.
+ * Each message is added at most once per packet, however often it is requested. Keys without a builder are ignored.
  * @param key - the module/message key for the desired message
  */
 void queueBbMessage(uint32_t key);
@@ -127,17 +472,30 @@ void queueBbMessage(uint32_t key);
 /**
  * Make a packet in the specified buffer that contains all queued messages
  * Note that a packet may not be fully completed, in which case the buffer will still have a length of zero
+ * Any messages that don't fit in the buffer are dropped, as the next packet may be a response to someone else
  * @param bb - the buffer to make the packet in
 
  */
 void makeBbPacketWithQueuedMessages(Bb* bb);
 
+/**
+ * Make as many packets as needed to hold all queued messages, each no bigger than the buffer
+ * Messages with size hints are packed so that as few packets as possible are made
+ * Every packet but the last is handed to next() when it is full. The last one is left in the buffer
+ * Messages that don't fit once next() is NULL or returns false are dropped, so they aren't sent to the next requester
+ * @param bb - the buffer to make the first packet in
+ * @param next - the function to send a full packet and provide a new buffer. If NULL then only one packet is made
+ * @param context - passed to next()
+ * @return the number of packets made
+ */
+uint32_t makeBbPacketsWithQueuedMessages(Bb* bb, BbNextBuffer next, void* context);
+
 /**
  * takes the specified value and rounds it up to the nearest multiple of 4
  * this is useful to compute the next greater index that is word-aligned
  * or to round up a message length to the nearest 4-bytes
  */
-BbBlock bbAlign(uint16_t i);
+BbBlock bbAlign(BbBlock i);
 
 /**
  * Checks if we've recevied a packet within the specified time
@@ -146,6 +504,11 @@ BbBlock bbAlign(uint16_t i);
  */
 bool isLastPacketTimeNotWithin(uint32_t microseconds);
 
+/**
+ * Checks if the specified context hasn't received a packet within the specified time
+ */
+bool isLastPacketTimeNotWithinCtx(BbContext* ctx, uint32_t microseconds);
+
 //*******************************************************************************************
 //Code
 //*******************************************************************************************
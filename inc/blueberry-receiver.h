@@ -31,16 +31,49 @@ THE SOFTWARE.
 
 #include <byteQ.h>
 #include <stdbool.h>
+#include <stdatomic.h>
 
 #include "blueberry-transcoder.h"
+#include "blueberry-parser.h"
 
 //*******************************************************************************************
 //Defines
 //*******************************************************************************************
 #define BB_UDP_PORT 0x4242
+#ifndef BB_HANDOFF_NUM
+#define BB_HANDOFF_NUM (8)//the number of received packets that can wait to be parsed. Must be a power of two
+#endif
 //*******************************************************************************************
 //Types
 //*******************************************************************************************
+/**
+ * where a received packet is in the receive queue
+ */
+typedef struct {
+	uint32_t start;//the index in the queue's buffer of the first byte of the packet
+	uint32_t length;//the number of bytes in the packet
+	uint32_t time;//when the packet started to arrive
+} BbPacketSpan;
+
+/**
+ * A lock free handoff of received packets from the receive interrupt to the main loop
+ * There must be a single producer, which frames packets with frameBbHandoff(), usually from the receive interrupt or DMA callback,
+ * and a single consumer, which parses and responds to them with processBbHandoff() from the main loop.
+ * The packets stay in the receive queue until they have been parsed, so nothing is copied
+ */
+typedef struct {
+	BbPacketSpan spans[BB_HANDOFF_NUM];
+	atomic_uint_fast32_t head;//the number of spans ever added. Only written by the producer
+	atomic_uint_fast32_t tail;//the number of spans ever taken. Only written by the consumer
+	atomic_uint_fast32_t framed;//the number of bytes ever framed or rejected. Only written by the producer
+	uint32_t released;//the number of bytes ever freed from the queue. Only used by the consumer
+	ByteQ* q;//the queue that the bytes arrive in. Its front is only moved by the consumer
+	ByteQ rxQ;//the producer's view of the queue, with its front at the first byte not yet framed
+	uint32_t framedFront;//the front of the producer's view when framed was last updated
+	Bb rx;//the producer's receive state
+	BbLinkStats link;//the health of the link, counted by the producer
+} BbHandoff;
+
 
 
 
@@ -65,6 +98,7 @@ THE SOFTWARE.
  * @param destPort - the port that this packet was sent to. This will be the blueberry port no doubt
  * @param data - the data payload of the packet
  * @param dataLength - the number of bytes of the packet
+ * This uses the default context, the same one as transceiveBrPacketN() and the other functions that don't take a context
  */
 
 bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t sourcePort, uint32_t destIp, uint16_t destPort, uint8_t* data, uint32_t dataLength);//EthernetPacket* ep,  Ipv4Packet* ip, UdpPacket* inUp);
@@ -73,6 +107,7 @@ bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t so
  * scans the input queue for packets, if found will respond with a response packet on the output queue.
  * this funcion will only process at most n bytes at a time
  * It uses the input buffer to store the recieving state between calls.
+ * This uses the default context, the same one as processBlueberryPacket() and the other functions that don't take a context
  *
  * @param inP - a packet used for receiving. This should be static
  * @param inQ - the queue that the bytes
@@ -81,6 +116,58 @@ bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t so
  */
 bool transceiveBrPacketN(Bb* inP, ByteQ* inQ, ByteQ* outQ, uint32_t n);
 
+/**
+ * scans the input queue for packets and responds on the output queue, using the specified context
+ * @see transceiveBrPacketN()
+ */
+bool transceiveBrPacketNCtx(BbContext* ctx, Bb* inP, ByteQ* inQ, ByteQ* outQ, uint32_t n);
+
+/**
+ * processes a UDP packet as a blueberry packet, using the specified context
+ * @see processBlueberryPacket()
+ */
+bool processBlueberryPacketCtx(BbContext* ctx, uint8_t sourceMac[6], uint32_t sourceIp, uint16_t sourcePort, uint32_t destIp, uint16_t destPort, uint8_t* data, uint32_t dataLength);
+
+/**
+ * gets the health counters of the link that the specified context receives from
+ */
+BbLinkStats* getBbLinkStats(BbContext* ctx);
+
+/**
+ * takes a snapshot of the health counters of a link
+ */
+void getBbLinkCounts(BbLinkStats* s, BbLinkCounts* counts);
+
+/**
+ * counts bytes that were dropped because the receive queue was full. This is for the code that fills the queue
+ */
+void recordBbLinkOverflow(BbLinkStats* s);
+
+/**
+ * sets up a handoff of received packets from the specified queue
+ */
+void initBbHandoff(BbHandoff* h, ByteQ* q);
+
+/**
+ * frames the packets that have arrived in the queue and hands them to the consumer. This is the producer side of the handoff
+ */
+uint32_t frameBbHandoff(BbHandoff* h, uint32_t n);
+
+/**
+ * gets the oldest packet that has been handed off, without removing it. This is the consumer side of the handoff
+ */
+bool takeBbHandoff(BbHandoff* h, Bb* bb);
+
+/**
+ * frees the packet got with takeBbHandoff() from the queue
+ */
+void releaseBbHandoff(BbHandoff* h);
+
+/**
+ * parses all the packets that have been handed off and responds on the output queue
+ */
+bool processBbHandoff(BbContext* ctx, BbHandoff* h, ByteQ* outQ);
+
 //*******************************************************************************************
 //Code
 //*******************************************************************************************
@@ -0,0 +1,83 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+#ifndef INC_BLUEBERRY_RING_H_
+#define INC_BLUEBERRY_RING_H_
+
+/**
+ * A module to allocate ring buffers for the ByteQs so that packets never wrap
+ * On Linux the same memory is mapped twice, back to back, so the byte after the end of the buffer is the first byte again.
+ * A packet that runs past the end of the buffer can then be read and written through plain pointers,
+ * and the parse, crc and bulk copies never take the wrap path.
+ * On other platforms, or if the mapping fails, an ordinary buffer is allocated and wraps as usual.
+ * The receiver looks up the buffer of each queue with getBbRingMirror(), so a mirrored ByteQ needs no other setup.
+ * The ByteQ must be given the size of the ring, which may have been rounded up, or it is treated as unmirrored.
+ *
+ * The list of open rings is not locked, since it is searched for every packet.
+ * Open the rings before any thread or interrupt that uses a ByteQ starts, and close them after they have all stopped.
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#ifndef BB_RING_NUM
+#define BB_RING_NUM (4)//the number of rings that can be open at once
+#endif
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * A ring buffer allocated by openBbRing()
+ */
+typedef struct {
+	uint8_t* buffer;//the start of the buffer
+	uint32_t size;//the size of the buffer in bytes. It may have been rounded up from the size asked for
+	bool mirrored;//true if the buffer is mapped a second time straight after itself
+} BbRing;
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * allocates a ring buffer, mirrored if the platform supports it
+ */
+bool openBbRing(BbRing* r, uint32_t size);
+
+/**
+ * frees a ring buffer allocated by openBbRing()
+ */
+void closeBbRing(BbRing* r);
+
+/**
+ * finds how many bytes after the end of the specified buffer mirror its start
+ */
+uint32_t getBbRingMirror(const uint8_t* buffer, uint32_t size);
+
+#endif /* INC_BLUEBERRY_RING_H_ */
@@ -0,0 +1,126 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef INC_BLUEBERRY_STATS_H_
+#define INC_BLUEBERRY_STATS_H_
+
+/**
+ * A module to count how often each message is parsed and built, how many bytes it takes and how long it takes
+ * This is only compiled in when BB_STATS is set to 1. Otherwise none of it is used and it costs nothing.
+ * The time is measured in cycles of the DWT cycle counter on Cortex-M, the time stamp counter on x86 or nanoseconds on other Linux hosts
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <blueberry-transcoder.h>
+#include <stdint.h>
+#include <stdbool.h>
+#if defined(__linux__) && !(defined(__x86_64__) || defined(__i386__))
+#include <time.h>
+#endif
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#ifndef BB_STATS
+#define BB_STATS (0)//set to 1 to count parsing and building of each message key
+#endif
+#ifndef BB_STATS_KEY_NUM
+#define BB_STATS_KEY_NUM (32)//the number of keys that can be counted. Must be a power of two
+#endif
+#define BB_STATS_BIN_NUM (12)//the number of bins of each histogram. Bin i counts times from 4^i up to 4^(i+1), the last bin counts everything longer
+#define BB_STATS_PARSE (0)
+#define BB_STATS_BUILD (1)
+#ifndef BB_STATS_MESSAGE_KEY
+#define BB_STATS_MESSAGE_KEY (0xfffe0001)//the key of the message made by buildBbStatsMessage()
+#endif
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * The counts for one message key
+ */
+typedef struct {
+	uint32_t key;
+	bool used;
+	uint32_t count[2];//the number of times the message was parsed and built, indexed by BB_STATS_PARSE or BB_STATS_BUILD
+	uint32_t bytes[2];//the number of bytes parsed and built
+	uint32_t histogram[2][BB_STATS_BIN_NUM];//how long each parse and build took
+} BbStatsEntry;
+
+/**
+ * The counts for all message keys of one context
+ */
+typedef struct {
+	BbStatsEntry entries[BB_STATS_KEY_NUM];
+	uint32_t unknownKeys;//the number of messages received that have no parser
+	uint32_t droppedKeys;//the number of times a key couldn't be counted because the table was full
+} BbStats;
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * gets the current time in cycles, for measuring how long a parser or builder takes
+ * This is inline so that it costs as little as possible
+ * @return the cycle count. This wraps, so only differences are meaningful
+ */
+static inline uint32_t getBbStatsCycles(void){
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+	return *(volatile uint32_t*)0xE0001004;//DWT->CYCCNT
+#elif (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+	return (uint32_t)__builtin_ia32_rdtsc();
+#elif defined(__linux__)
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint32_t)t.tv_sec*1000000000u + (uint32_t)t.tv_nsec;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * forgets all the counts, and starts the cycle counter if needed
+ */
+void resetBbStats(BbStats* s);
+
+/**
+ * counts one parse or build of a message
+ */
+void recordBbStats(BbStats* s, uint32_t kind, uint32_t key, uint32_t bytes, uint32_t cycles);
+
+/**
+ * gets the counts for the specified key
+ */
+const BbStatsEntry* getBbStatsEntry(const BbStats* s, uint32_t key);
+
+/**
+ * builds a message containing the counts, so they can be read remotely
+ */
+void buildBbStatsMessage(Bb* bb, BbBlock msg, uint32_t key, const BbStats* s);
+
+#endif /* INC_BLUEBERRY_STATS_H_ */
@@ -29,10 +29,30 @@ THE SOFTWARE.
 //*******************************************************************************************
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 //*******************************************************************************************
 //Defines
 //*******************************************************************************************
+//build with BB_LARGE_PACKETS set to 1 to make and parse packets of up to 256KB, as allowed by the length in the packet header
+//blocks are then 32 bits, and packets with a buffer bigger than 64KB store their sequence and string offsets in words
+#ifndef BB_LARGE_PACKETS
+#define BB_LARGE_PACKETS (0)
+#endif
+
+#if BB_LARGE_PACKETS
+#define BB_INVALID_BLOCK (0xffffffff)
+#else
 #define BB_INVALID_BLOCK (0xffff)
+#endif
+
+//packets are little endian, so big endian targets swap every multi-byte field
+#ifndef BB_BIG_ENDIAN
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define BB_BIG_ENDIAN (1)
+#else
+#define BB_BIG_ENDIAN (0)
+#endif
+#endif
 
 //*******************************************************************************************
 //Types
@@ -48,6 +68,13 @@ typedef struct {
     uint32_t bufferLength;//the length of the buffer, assuming it's circular
     uint32_t time; //the time that this packet was received, in
     uint8_t* buffer;//a pointer to an array of bytes (i.e. the buffer)
+    uint32_t linearLength;//the number of bytes from the start of the packet that do not wrap. Set by updateBbLinear()
+    uint32_t crcLength;//while receiving, the number of bytes of the packet that have been folded into crc
+    uint16_t crc;//while receiving, the running crc of the packet
+    uint32_t wrapMask;//bufferLength - 1 if that is a power of two, otherwise 0. Set by updateBbLinear()
+    uint32_t mirrorLength;//the number of bytes after the end of the buffer that mirror its start, 0 if it isn't mirrored
+    uint32_t writeLimit;//the number of bytes from the start of the packet that the checked setters may write, 0 for the whole buffer
+    bool verified;//true once every message of the packet has been checked by validateBbPacket(). Cleared by updateBbLinear()
 } Bb;
 
 
@@ -57,8 +84,13 @@ typedef struct {
  * even if the buffer wraps part way through the packet.
  * If this value is i and the packet length is n, then 0 <= i < n.
  * An official invalid value for a block is 0xffff, or BB_INVALID_BLOCK
+ * With BB_LARGE_PACKETS this is 32 bits, and the invalid value is 0xffffffff
  */
+#if BB_LARGE_PACKETS
+typedef uint32_t BbBlock;
+#else
 typedef uint16_t BbBlock;
+#endif
 //typedef uint32_t BbArray;//ditto
 
 //*******************************************************************************************
@@ -73,83 +105,109 @@ typedef uint16_t BbBlock;
 /**
  *  gets an 8-bit, unsigned integer from the specified block
  */
-uint8_t getBbUint8(Bb* buf, BbBlock p, uint16_t i);
+uint8_t getBbUint8(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets an 8-bit, unsigned integer in the specified block
  */
-void setBbUint8(Bb* buf, BbBlock p, uint16_t i, uint8_t v);
+void setBbUint8(Bb* buf, BbBlock p, BbBlock i, uint8_t v);
 
 /**
  * gets an 8-bit, signed integer from thespecified block
  */
-int8_t getBbInt8(Bb* buf, BbBlock p, uint16_t i);
+int8_t getBbInt8(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets an 8-bit signed integer in the specified block
  */
-void setBbInt8(Bb* buf, BbBlock p, uint16_t i, int8_t v);
+void setBbInt8(Bb* buf, BbBlock p, BbBlock i, int8_t v);
 
 
 /**
  *  gets a 16-bit, unsigned integer from the specified block
  */
-uint16_t getBbUint16(Bb* buf, BbBlock p, uint16_t i);
+uint16_t getBbUint16(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets a 16-bit, unsigned integer in the specified block
  */
-void setBbUint16(Bb* buf, BbBlock p, uint16_t i, uint16_t v);
+void setBbUint16(Bb* buf, BbBlock p, BbBlock i, uint16_t v);
 
 /**
  * gets a 16-bit, signed integer from thespecified block
  */
-int16_t getBbInt16(Bb* buf, BbBlock p, uint16_t i);
+int16_t getBbInt16(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets a 16-bit signed integer in the specified block
  */
-void setBbInt16(Bb* buf, BbBlock p, uint16_t i, int16_t v);
+void setBbInt16(Bb* buf, BbBlock p, BbBlock i, int16_t v);
 
 /**
  *  gets a 32-bit, unsigned integer from the specified block
  */
-uint32_t getBbUint32(Bb* buf, BbBlock p, uint16_t i);
+uint32_t getBbUint32(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets a 32-bit, unsigned integer in the specified block
  */
-void setBbUint32(Bb* buf, BbBlock p, uint16_t i, uint32_t v);
+void setBbUint32(Bb* buf, BbBlock p, BbBlock i, uint32_t v);
 
 /**
  * gets a 32-bit, signed integer from thespecified block
  */
-int32_t getBbInt32(Bb* buf, BbBlock p, uint16_t i);
+int32_t getBbInt32(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets a 32-bit signed integer in the specified block
  */
-void setBbInt32(Bb* buf, BbBlock p, uint16_t i, int32_t v);
+void setBbInt32(Bb* buf, BbBlock p, BbBlock i, int32_t v);
 
 /**
  *  gets a 32-bit, floating point value from the specified block
  */
-float getBbFloat32(Bb* buf, BbBlock p, uint16_t i);
+float getBbFloat32(Bb* buf, BbBlock p, BbBlock i);
 
 /**
  * sets a a 32-bit, floating point value in the specified block
  */
-void setBbFloat32(Bb* buf, BbBlock p, uint16_t i, float v);
+void setBbFloat32(Bb* buf, BbBlock p, BbBlock i, float v);
 
 /**
  * extracts a boolean from the specified block
  */
-bool getBbBool(Bb* buf, BbBlock p, uint16_t i, uint32_t bitNum);
+bool getBbBool(Bb* buf, BbBlock p, BbBlock i, uint32_t bitNum);
 
 /**
  * sets a boolean in a specified block
  */
-void setBbBool(Bb* buf, BbBlock p, uint16_t i, uint32_t bitNum, bool v);
+void setBbBool(Bb* buf, BbBlock p, BbBlock i, uint32_t bitNum, bool v);
+
+/**
+ * computes how much of the packet can be accessed without wrapping, and if the buffer can be wrapped with a mask
+ * This should be called once the start, length and buffer of the packet are known
+ */
+void updateBbLinear(Bb* buf);
+
+/**
+ * tests if the buffer can be wrapped with a mask, so the masked accessors can be used
+ */
+bool isBbMasked(Bb* buf);
+
+/**
+ * tests if the packet has been validated, so the verified accessors can be used
+ */
+bool isBbVerified(Bb* buf);
+
+/**
+ * copies the specified number of bytes from the specified block to memory
+ */
+void getBbBytes(Bb* buf, BbBlock p, BbBlock i, uint8_t* dest, uint32_t n);
+
+/**
+ * copies the specified number of bytes from memory to the specified block
+ */
+void setBbBytes(Bb* buf, BbBlock p, BbBlock i, const uint8_t* src, uint32_t n);
 
 /**
  * converts a linear index to a circular one
@@ -163,14 +221,445 @@ uint32_t bbWrap(Bb* buf, int i);
 uint16_t computeCrc(Bb* buf, BbBlock start, BbBlock end);
 
 /**
- * tests if the specified index is not equal to the invalid value 0xffffffff
+ * folds the specified blocks of the buffer into a running crc
+ */
+uint16_t foldBbCrc(Bb* buf, uint16_t crc, BbBlock start, BbBlock end);
+
+/**
+ * tests if the specified index is equal to the invalid value BB_INVALID_BLOCK
  */
-bool isBbIndexValid(BbBlock b);
+bool isBbBlockInvalid(BbBlock b);
 
 //*******************************************************************************************
 //Code
 //*******************************************************************************************
 
+/**
+ * converts a 16-bit value between the byte order of the target and the little endian order of a packet
+ */
+static inline uint16_t bbLittleEndian16(uint16_t v){
+#if BB_BIG_ENDIAN
+	return (uint16_t)((v >> 8) | (v << 8));
+#else
+	return v;
+#endif
+}
+
+/**
+ * converts a 32-bit value between the byte order of the target and the little endian order of a packet
+ */
+static inline uint32_t bbLittleEndian32(uint32_t v){
+#if BB_BIG_ENDIAN
+	return (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+#else
+	return v;
+#endif
+}
+
+/**
+ * reads a little endian 32-bit word from memory, whatever the byte order of the target
+ * This is how the fast accessors and the CRC take the words of a packet
+ * @param p the first byte of the word. This does not need to be aligned
+ * @return the value
+ */
+static inline uint32_t loadBbLittleEndian32(const uint8_t* p){
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return bbLittleEndian32(v);
+}
+
+/*
+ * The fast accessors are inline so that a generated parser compiles to a load or store per field.
+ * Fields that lie in the linear part of the packet are accessed with memcpy(), which compiles to a single unaligned load or store,
+ * and anything else falls back to the out of line accessors, which wrap.
+ */
+
+/**
+ *  gets an 8-bit, unsigned integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline uint8_t getBbUint8Fast(Bb* buf, BbBlock block, BbBlock i){
+	uint32_t j = (uint32_t)block + i;
+	uint8_t result;
+	if(j < buf->linearLength){
+		result = buf->buffer[buf->start + j];
+	} else {
+		result = getBbUint8(buf, block, i);
+	}
+	return result;
+}
+
+/**
+ * sets an 8-bit, unsigned integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbUint8Fast(Bb* buf, BbBlock block, BbBlock i, uint8_t v){
+	uint32_t j = (uint32_t)block + i;
+	if(j < buf->linearLength){
+		buf->buffer[buf->start + j] = v;
+	} else {
+		setBbUint8(buf, block, i, v);
+	}
+}
+
+/**
+ * gets an 8-bit, signed integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline int8_t getBbInt8Fast(Bb* buf, BbBlock block, BbBlock i){
+	return (int8_t)getBbUint8Fast(buf, block, i);
+}
+
+/**
+ * sets an 8-bit, signed integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbInt8Fast(Bb* buf, BbBlock block, BbBlock i, int8_t v){
+	setBbUint8Fast(buf, block, i, (uint8_t)v);
+}
+
+/**
+ *  gets a 16-bit, unsigned integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline uint16_t getBbUint16Fast(Bb* buf, BbBlock block, BbBlock i){
+	uint32_t j = (uint32_t)block + i;
+	uint16_t result;
+	if(j + 2 <= buf->linearLength){
+		memcpy(&result, &buf->buffer[buf->start + j], 2);
+		result = bbLittleEndian16(result);
+	} else {
+		result = getBbUint16(buf, block, i);
+	}
+	return result;
+}
+
+/**
+ * sets a 16-bit, unsigned integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbUint16Fast(Bb* buf, BbBlock block, BbBlock i, uint16_t v){
+	uint32_t j = (uint32_t)block + i;
+	if(j + 2 <= buf->linearLength){
+		v = bbLittleEndian16(v);
+		memcpy(&buf->buffer[buf->start + j], &v, 2);
+	} else {
+		setBbUint16(buf, block, i, v);
+	}
+}
+
+/**
+ * gets a 16-bit, signed integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline int16_t getBbInt16Fast(Bb* buf, BbBlock block, BbBlock i){
+	return (int16_t)getBbUint16Fast(buf, block, i);
+}
+
+/**
+ * sets a 16-bit, signed integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbInt16Fast(Bb* buf, BbBlock block, BbBlock i, int16_t v){
+	setBbUint16Fast(buf, block, i, (uint16_t)v);
+}
+
+/**
+ *  gets a 32-bit, unsigned integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline uint32_t getBbUint32Fast(Bb* buf, BbBlock block, BbBlock i){
+	uint32_t j = (uint32_t)block + i;
+	uint32_t result;
+	if(j + 4 <= buf->linearLength){
+		result = loadBbLittleEndian32(&buf->buffer[buf->start + j]);
+	} else {
+		result = getBbUint32(buf, block, i);
+	}
+	return result;
+}
+
+/**
+ * sets a 32-bit, unsigned integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbUint32Fast(Bb* buf, BbBlock block, BbBlock i, uint32_t v){
+	uint32_t j = (uint32_t)block + i;
+	if(j + 4 <= buf->linearLength){
+		v = bbLittleEndian32(v);
+		memcpy(&buf->buffer[buf->start + j], &v, 4);
+	} else {
+		setBbUint32(buf, block, i, v);
+	}
+}
+
+/**
+ * gets a 32-bit, signed integer from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline int32_t getBbInt32Fast(Bb* buf, BbBlock block, BbBlock i){
+	return (int32_t)getBbUint32Fast(buf, block, i);
+}
+
+/**
+ * sets a 32-bit, signed integer in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbInt32Fast(Bb* buf, BbBlock block, BbBlock i, int32_t v){
+	setBbUint32Fast(buf, block, i, (uint32_t)v);
+}
+
+/**
+ *  gets a 32-bit, floating point value from the specified block, skipping the wrap if possible
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @return the value
+ */
+static inline float getBbFloat32Fast(Bb* buf, BbBlock block, BbBlock i){
+	uint32_t ip = getBbUint32Fast(buf, block, i);
+	float result;
+	memcpy(&result, &ip, 4);
+	return result;
+}
+
+/**
+ * sets a 32-bit, floating point value in the specified block, skipping the wrap if possible
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param v the value to write
+ */
+static inline void setBbFloat32Fast(Bb* buf, BbBlock block, BbBlock i, float v){
+	uint32_t ip;
+	memcpy(&ip, &v, 4);
+	setBbUint32Fast(buf, block, i, ip);
+}
+
+
+/*
+ * The masked accessors are for buffers that are a power of two in size, such as the ByteQs.
+ * They wrap every byte with wrapMask instead of a modulo, and with no bounds checks, so they compile to straight line code.
+ * Only use them once isBbMasked() is true, and only for fields that are inside the packet.
+ * They read and write the same bytes as the other accessors, so the two can be mixed freely.
+ */
+
+/**
+ * gets an 8-bit, unsigned integer from the specified block, wrapping with the mask
+ */
+static inline uint8_t getBbUint8Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return buf->buffer[(buf->start + block + i) & buf->wrapMask];
+}
+
+/**
+ * sets an 8-bit, unsigned integer in the specified block, wrapping with the mask
+ */
+static inline void setBbUint8Masked(Bb* buf, BbBlock block, BbBlock i, uint8_t v){
+	buf->buffer[(buf->start + block + i) & buf->wrapMask] = v;
+}
+
+/**
+ * gets an 8-bit, signed integer from the specified block, wrapping with the mask
+ */
+static inline int8_t getBbInt8Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return (int8_t)getBbUint8Masked(buf, block, i);
+}
+
+/**
+ * sets an 8-bit, signed integer in the specified block, wrapping with the mask
+ */
+static inline void setBbInt8Masked(Bb* buf, BbBlock block, BbBlock i, int8_t v){
+	setBbUint8Masked(buf, block, i, (uint8_t)v);
+}
+
+/**
+ * gets a 16-bit, unsigned integer from the specified block, wrapping with the mask
+ */
+static inline uint16_t getBbUint16Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return (uint16_t)(getBbUint8Masked(buf, block, i) | (getBbUint8Masked(buf, block, i+1) << 8));
+}
+
+/**
+ * sets a 16-bit, unsigned integer in the specified block, wrapping with the mask
+ */
+static inline void setBbUint16Masked(Bb* buf, BbBlock block, BbBlock i, uint16_t v){
+	setBbUint8Masked(buf, block, i,   (uint8_t)v);
+	setBbUint8Masked(buf, block, i+1, (uint8_t)(v >> 8));
+}
+
+/**
+ * gets a 16-bit, signed integer from the specified block, wrapping with the mask
+ */
+static inline int16_t getBbInt16Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return (int16_t)getBbUint16Masked(buf, block, i);
+}
+
+/**
+ * sets a 16-bit, signed integer in the specified block, wrapping with the mask
+ */
+static inline void setBbInt16Masked(Bb* buf, BbBlock block, BbBlock i, int16_t v){
+	setBbUint16Masked(buf, block, i, (uint16_t)v);
+}
+
+/**
+ * gets a 32-bit, unsigned integer from the specified block, wrapping with the mask
+ */
+static inline uint32_t getBbUint32Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return (uint32_t)getBbUint8Masked(buf, block, i)
+		| ((uint32_t)getBbUint8Masked(buf, block, i+1) << 8)
+		| ((uint32_t)getBbUint8Masked(buf, block, i+2) << 16)
+		| ((uint32_t)getBbUint8Masked(buf, block, i+3) << 24);
+}
+
+/**
+ * sets a 32-bit, unsigned integer in the specified block, wrapping with the mask
+ */
+static inline void setBbUint32Masked(Bb* buf, BbBlock block, BbBlock i, uint32_t v){
+	setBbUint8Masked(buf, block, i,   (uint8_t)v);
+	setBbUint8Masked(buf, block, i+1, (uint8_t)(v >> 8));
+	setBbUint8Masked(buf, block, i+2, (uint8_t)(v >> 16));
+	setBbUint8Masked(buf, block, i+3, (uint8_t)(v >> 24));
+}
+
+/**
+ * gets a 32-bit, signed integer from the specified block, wrapping with the mask
+ */
+static inline int32_t getBbInt32Masked(const Bb* buf, BbBlock block, BbBlock i){
+	return (int32_t)getBbUint32Masked(buf, block, i);
+}
+
+/**
+ * sets a 32-bit, signed integer in the specified block, wrapping with the mask
+ */
+static inline void setBbInt32Masked(Bb* buf, BbBlock block, BbBlock i, int32_t v){
+	setBbUint32Masked(buf, block, i, (uint32_t)v);
+}
+
+/**
+ * gets a 32-bit, floating point value from the specified block, wrapping with the mask
+ */
+static inline float getBbFloat32Masked(const Bb* buf, BbBlock block, BbBlock i){
+	uint32_t ip = getBbUint32Masked(buf, block, i);
+	float result;
+	memcpy(&result, &ip, 4);
+	return result;
+}
+
+/**
+ * sets a 32-bit, floating point value in the specified block, wrapping with the mask
+ */
+static inline void setBbFloat32Masked(Bb* buf, BbBlock block, BbBlock i, float v){
+	uint32_t ip;
+	memcpy(&ip, &v, 4);
+	setBbUint32Masked(buf, block, i, ip);
+}
+
+
+/*
+ * The verified accessors are for the parsers of a packet that validateBbPacket() has passed, which is then linear and has
+ * every message, sequence and string inside it. They skip all the wrap and bounds checks, so each is a single load.
+ * Only use them while isBbVerified() is true, and only for fields up to the max ordinal of the message.
+ */
+
+/**
+ * gets an 8-bit, unsigned integer from the specified block of a verified packet
+ */
+static inline uint8_t getBbUint8Verified(const Bb* buf, BbBlock block, BbBlock i){
+	return buf->buffer[buf->start + block + i];
+}
+
+/**
+ * gets an 8-bit, signed integer from the specified block of a verified packet
+ */
+static inline int8_t getBbInt8Verified(const Bb* buf, BbBlock block, BbBlock i){
+	return (int8_t)getBbUint8Verified(buf, block, i);
+}
+
+/**
+ * gets a 16-bit, unsigned integer from the specified block of a verified packet
+ */
+static inline uint16_t getBbUint16Verified(const Bb* buf, BbBlock block, BbBlock i){
+	uint16_t result;
+	memcpy(&result, &buf->buffer[buf->start + block + i], 2);
+	return bbLittleEndian16(result);
+}
+
+/**
+ * gets a 16-bit, signed integer from the specified block of a verified packet
+ */
+static inline int16_t getBbInt16Verified(const Bb* buf, BbBlock block, BbBlock i){
+	return (int16_t)getBbUint16Verified(buf, block, i);
+}
+
+/**
+ * gets a 32-bit, unsigned integer from the specified block of a verified packet
+ */
+static inline uint32_t getBbUint32Verified(const Bb* buf, BbBlock block, BbBlock i){
+	uint32_t result;
+	memcpy(&result, &buf->buffer[buf->start + block + i], 4);
+	return bbLittleEndian32(result);
+}
+
+/**
+ * gets a 32-bit, signed integer from the specified block of a verified packet
+ */
+static inline int32_t getBbInt32Verified(const Bb* buf, BbBlock block, BbBlock i){
+	return (int32_t)getBbUint32Verified(buf, block, i);
+}
+
+/**
+ * gets a 32-bit, floating point value from the specified block of a verified packet
+ */
+static inline float getBbFloat32Verified(const Bb* buf, BbBlock block, BbBlock i){
+	uint32_t ip = getBbUint32Verified(buf, block, i);
+	float result;
+	memcpy(&result, &ip, 4);
+	return result;
+}
+
+/**
+ * extracts a boolean from the specified block of a verified packet
+ */
+static inline bool getBbBoolVerified(const Bb* buf, BbBlock block, BbBlock i, uint32_t bitMask){
+	return (getBbUint8Verified(buf, block, i) & bitMask) != 0;
+}
+
 
 #endif /* BLUEBERRY_TRANSCODE_FIRMWARE_H_ */
 
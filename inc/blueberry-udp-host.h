@@ -0,0 +1,88 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef INC_BLUEBERRY_UDP_HOST_H_
+#define INC_BLUEBERRY_UDP_HOST_H_
+
+/**
+ * A module to run blueberry endpoints on a Linux host over POSIX UDP sockets
+ * It provides the ethernet hooks that the firmware gets from its network stack (registerUdpListener(), startUdpPacket(),
+ * completeUdpPacket() and setEthernetPort()), so the receiver runs unchanged on the host.
+ * Datagrams are received and sent in batches with recvmmsg() and sendmmsg(), and responses are built in place
+ * in preallocated buffers, so there is no allocation or copying per packet.
+ * The module is empty on other platforms
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <stdint.h>
+#include <stdbool.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#ifndef BB_UDP_HOST_LISTENER_NUM
+#define BB_UDP_HOST_LISTENER_NUM (4)//the number of ports that can be listened to
+#endif
+#ifndef BB_UDP_HOST_BATCH
+#define BB_UDP_HOST_BATCH (32)//the number of datagrams received or sent with one system call
+#endif
+#ifndef BB_UDP_HOST_MTU
+#define BB_UDP_HOST_MTU (1472)//the largest UDP payload that is sent or received, an ethernet frame without the IP and UDP headers
+#endif
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * waits for datagrams on the registered ports and hands each to its listener
+ * Any responses are sent before this returns
+ * @param timeoutMs - how long to wait for a datagram, in milliseconds. 0 to not wait, -1 to wait forever
+ * @return the number of datagrams received
+ */
+uint32_t pollBbUdpHost(int32_t timeoutMs);
+
+/**
+ * sends any responses that have been completed but not yet sent
+ */
+void flushBbUdpHost(void);
+
+/**
+ * gets the number of datagrams received that were bigger than BB_UDP_HOST_MTU
+ */
+uint32_t getBbUdpHostTruncatedNum(void);
+
+/**
+ * closes all the sockets and forgets the listeners
+ */
+void closeBbUdpHost(void);
+
+#endif /* INC_BLUEBERRY_UDP_HOST_H_ */
@@ -25,7 +25,8 @@ THE SOFTWARE.
 //includes
 //********************************************************************************
 #include <blueberry-message.h>
-
+#include <blueberry-parser.h>
+#include <string.h>
 
 //********************************************************************************
 //defines
@@ -45,6 +46,8 @@ THE SOFTWARE.
 #define STRING_BLOCK_LENGTH_INDEX 0
 #define STRING_BLOCK_DATA_START_INDEX 4
 
+#define PLACEHOLDER_INVALID (0xffff)//how an empty sequence or string is stored in its placeholder
+
 
 
 
@@ -67,6 +70,12 @@ THE SOFTWARE.
  * @param msg - the index of the beginning of the message
  */
 static void updateBbMessageLength(Bb* bb, BbBlock msg);
+static BbBlock getBbPlaceholderBlock(Bb* buf, BbBlock msg, BbBlock i);
+static void setBbPlaceholderBlock(Bb* buf, BbBlock msg, BbBlock i, BbBlock block);
+static uint32_t copyBbSequence(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, void* dest, const void* src, uint32_t n, uint32_t elementByteNum);
+#if BB_BIG_ENDIAN
+static void swapBbElements(void* p, uint32_t n, uint32_t elementByteNum);
+#endif
 //********************************************************************************
 //code
 //********************************************************************************
@@ -77,7 +86,7 @@ static void updateBbMessageLength(Bb* bb, BbBlock msg);
  * @param msg - the index of the beginning of the message
  */
 uint32_t getBbMessageKey(Bb* bb, BbBlock msg){
-	return getBbUint32(bb, msg, MODULE_MESSAGE_KEY_INDEX);
+	return getBbUint32Fast(bb, msg, MODULE_MESSAGE_KEY_INDEX);
 }
 /**
  * gets the max ordinal field from the specified message
@@ -87,7 +96,7 @@ uint32_t getBbMessageKey(Bb* bb, BbBlock msg){
  * @param msg - the index of the beginning of the message
  */
 uint8_t getBbMessageMaxOrdinal(Bb* bb, BbBlock msg){
-	return getBbUint8(bb, msg, MESSAGE_MAX_ORDINAL_INDEX);
+	return getBbUint8Fast(bb, msg, MESSAGE_MAX_ORDINAL_INDEX);
 }
 /**
  * gets the length of this message in bytes
@@ -95,7 +104,7 @@ uint8_t getBbMessageMaxOrdinal(Bb* bb, BbBlock msg){
  * @param msg - the index of the beginning of the message
  */
 uint32_t getBbMessageLength(Bb* bb, BbBlock msg){
-	return (uint32_t)getBbUint16(bb, msg, MESSAGE_LENGTH_INDEX)*4;
+	return (uint32_t)getBbUint16Fast(bb, msg, MESSAGE_LENGTH_INDEX)*4;
 }
 /**
  * updates the message length field fromm the buffer length
@@ -104,7 +113,50 @@ uint32_t getBbMessageLength(Bb* bb, BbBlock msg){
  * @param msg - the index of the beginning of the message
  */
 static void updateBbMessageLength(Bb* bb, BbBlock msg){
-	setBbUint16(bb, msg, MESSAGE_LENGTH_INDEX, bbAlign((uint16_t)(bb->length - (uint32_t)msg))/4);
+	updateBbLinear(bb);//the message has grown so more of it may be accessible without wrapping
+	uint32_t n = (bb->length - (uint32_t)msg + 3u) & ~3u;//not bbAlign(), which would truncate a message past 64 KB
+	setBbUint16Fast(bb, msg, MESSAGE_LENGTH_INDEX, (uint16_t)(n/4));
+}
+
+/**
+ * gets the block of a sequence or string from its placeholder
+ * Large packets store the offset in words, so that it can reach past 64KB. Others store it in bytes
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the block index in the placeholder
+ * @return the index of the block relative to the message start, or BB_INVALID_BLOCK if there isn't one
+ */
+static BbBlock getBbPlaceholderBlock(Bb* buf, BbBlock msg, BbBlock i){
+	uint16_t b = getBbUint16(buf, msg, i);
+	if(b == PLACEHOLDER_INVALID){
+		return BB_INVALID_BLOCK;
+	}
+#if BB_LARGE_PACKETS
+	if(isBbPacketLarge(buf)){
+		return (BbBlock)b*4;
+	}
+#endif
+	return (BbBlock)b;
+}
+
+/**
+ * records the block of a sequence or string in its placeholder
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the block index in the placeholder
+ * @param block - the index of the block relative to the message start, or BB_INVALID_BLOCK if there isn't one
+ */
+static void setBbPlaceholderBlock(Bb* buf, BbBlock msg, BbBlock i, BbBlock block){
+	uint16_t b = PLACEHOLDER_INVALID;
+	if(block != BB_INVALID_BLOCK){
+		b = (uint16_t)block;
+#if BB_LARGE_PACKETS
+		if(isBbPacketLarge(buf)){
+			b = (uint16_t)(block/4);
+		}
+#endif
+	}
+	setBbUint16(buf, msg, i, b);
 }
 
 
@@ -116,7 +168,7 @@ static void updateBbMessageLength(Bb* bb, BbBlock msg){
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  * @param sequenceElement - the index of the sequence element. This must be smaller than the sequence length - but this is not checked here.
  */
-BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t sequenceElement){
+BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, BbBlock i, uint32_t sequenceElement){
 	//if index is invalid then return
 	if(isBbBlockInvalid(i)){
 		return i;
@@ -124,7 +176,7 @@ BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t seq
 	//get byte number per element
 	uint32_t bn = (uint32_t)getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_ELEMENT_LENGTH_INDEX);
 	//get the index of the block containing the sequence data
-	BbBlock result = (BbBlock)getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
+	BbBlock result = getBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
 	//now add on the displacement into the sequence data of the desired element
 	result += SEQUENCE_BLOCK_DATA_START_INDEX + sequenceElement*bn;
 	return result;
@@ -136,13 +188,13 @@ BbBlock getBbSequenceElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t seq
  * @param msg - the index of the beginning of the message
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  */
-uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, uint16_t i){
+uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, BbBlock i){
 	//if index is invalid then return
 	if(isBbBlockInvalid(i)){
 		return 0;
 	}
 	//get the index of the block containing the sequence data
-	BbBlock si = (BbBlock)getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
+	BbBlock si = getBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
 	uint32_t result = 0;
 	//now add on the displacement into the sequence data of the desired element
 	if(si != BB_INVALID_BLOCK){
@@ -150,6 +202,54 @@ uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, uint16_t i){
 	}
 	return result;
 }
+/**
+ * Checks that the block of the specified sequence is empty or lies entirely within the message
+ * This is what makes it safe to read the sequence without checking each element, once the packet has been validated
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
+ * @return true if the placeholder is in the message, and the sequence is empty or its elements fit in the message
+ */
+bool checkBbSequenceBlock(Bb* buf, BbBlock msg, BbBlock i){
+	uint32_t len = getBbMessageLength(buf, msg);
+	if((uint32_t)i + 4 > len){
+		return false;//the placeholder itself isn't in the message
+	}
+	BbBlock si = getBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);
+	if(si == BB_INVALID_BLOCK){
+		return true;//an empty sequence
+	}
+	if(si < MESSAGE_FIRST_DATA || (uint32_t)si + SEQUENCE_BLOCK_DATA_START_INDEX > len){
+		return false;
+	}
+	uint64_t bn = getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_ELEMENT_LENGTH_INDEX);
+	uint64_t n = getBbUint32(buf, msg + si, SEQUENCE_BLOCK_ELEMENTS_NUM_INDEX);
+	return n*bn <= len - si - SEQUENCE_BLOCK_DATA_START_INDEX;
+}
+
+/**
+ * Checks that the block of the specified string is empty or lies entirely within the message
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the string placeholder (which consists of a an index to the string length field (uint16))
+ * @return true if the placeholder is in the message, and the string is empty or its characters fit in the message
+ */
+bool checkBbStringBlock(Bb* buf, BbBlock msg, BbBlock i){
+	uint32_t len = getBbMessageLength(buf, msg);
+	if((uint32_t)i + 2 > len){
+		return false;//the placeholder itself isn't in the message
+	}
+	BbBlock si = getBbPlaceholderBlock(buf, msg, i + STRING_PLACEHOLDER_BLOCK_INDEX);
+	if(si == BB_INVALID_BLOCK){
+		return true;//an empty string
+	}
+	if(si < MESSAGE_FIRST_DATA || (uint32_t)si + STRING_BLOCK_DATA_START_INDEX > len){
+		return false;
+	}
+	uint32_t n = getBbUint32(buf, msg + si, STRING_BLOCK_LENGTH_INDEX);
+	return n <= len - si - STRING_BLOCK_DATA_START_INDEX;
+}
+
 /**
  * Gets the length of the specified sequence.
  * This can be used to read or write from the specified sequence element
@@ -157,13 +257,13 @@ uint32_t getBbSequenceLength(Bb*buf, BbBlock msg, uint16_t i){
  * @param msg - the index of the beginning of the message
  * @param i - the index (in bytes) of the string placeholder (which consists of a an index to the string length field (uint16))
  */
-uint32_t getBbStringLength(Bb*buf, BbBlock msg, uint16_t i){
+uint32_t getBbStringLength(Bb*buf, BbBlock msg, BbBlock i){
 	//if index is invalid then return
 	if(isBbBlockInvalid(i)){
 		return 0;
 	}
 	//get the index of the block containing the sequence data
-	BbBlock si = (BbBlock)getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
+	BbBlock si = getBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
 	uint32_t result = 0;
 	//now add on the displacement into the sequence data of the desired element
 	if(si != BB_INVALID_BLOCK){
@@ -181,9 +281,9 @@ uint32_t getBbStringLength(Bb*buf, BbBlock msg, uint16_t i){
  * @param n - the maximum number of characters to copy.
  * @return the number of characters copied
  */
-uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, uint16_t i, char* dest, uint32_t n){
+uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, BbBlock i, char* dest, uint32_t n){
 	//get the index of the block containing the string data
-	BbBlock si = (BbBlock)getBbUint16(buf, msg, i + STRING_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
+	BbBlock si = getBbPlaceholderBlock(buf, msg, i + STRING_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
 	if(isBbBlockInvalid(si)){
 		return 0;
 	}
@@ -193,13 +293,8 @@ uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, uint16_t i, char* dest, u
 	if(m > n){
 		m = n;
 	}
-	uint32_t j = 0;
-	uint32_t k = STRING_BLOCK_DATA_START_INDEX;
-	for(; j < m; ++j){
-		dest[j] = getBbUint8(buf, si, k);
-		++k;
-	}
-	dest[j] = 0;//add null termination
+	getBbBytes(buf, si, STRING_BLOCK_DATA_START_INDEX, (uint8_t*)dest, m);
+	dest[m] = 0;//add null termination
 	return m;
 }
 
@@ -213,7 +308,7 @@ uint32_t copyBbStringFromMessage(Bb* buf, BbBlock msg, uint16_t i, char* dest, u
  * @param n - the maximum number of characters to copy.
  * @return the number of characters copied
  */
-uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, uint16_t i, char* src, uint32_t n){
+uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, BbBlock i, char* src, uint32_t n){
 	BbBlock si;
 	uint32_t slen = 0;
 	if(n == 0){
@@ -221,26 +316,22 @@ uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, uint16_t i, char* src, uint
 		si = BB_INVALID_BLOCK;
 	} else {
 		//first choose a spot to place the string and record it
-		si = buf->length;
+		//blocks are word aligned, so that a large packet can store the offset in words
+		//this is done in 32 bits, as bbAlign() would truncate a packet or string past 64 KB
+		uint32_t start = (buf->length + 3u) & ~3u;
+		si = (BbBlock)start;
 
-		for(; slen < n; ++slen){
-			if(src[slen] == '\0'){
-				break;
-			}
-		}
+		const char* end = memchr(src, '\0', n);
+		slen = end == NULL ? n : (uint32_t)(end - src);
 		//now slen contains the length of the string
 
 
 
-		buf->length += bbAlign(slen + STRING_BLOCK_DATA_START_INDEX);//advance buffer length in preparation
+		buf->length = start + ((slen + STRING_BLOCK_DATA_START_INDEX + 3u) & ~3u);//advance buffer length in preparation
 
 
 		//now copy the data
-		for(uint32_t j = 0; j < slen; ++j){
-			char c = src[j];
-			setBbUint8(buf, si, STRING_BLOCK_DATA_START_INDEX + j, c);
-
-		}
+		setBbBytes(buf, si, STRING_BLOCK_DATA_START_INDEX, (const uint8_t*)src, slen);
 		//now record the length
 		setBbUint32(buf, si, STRING_BLOCK_LENGTH_INDEX, slen);
 
@@ -252,7 +343,7 @@ uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, uint16_t i, char* src, uint
 		si -= msg;
 	}
 	//record the string block in the placeholder
-	setBbUint16(buf, msg, i + STRING_PLACEHOLDER_BLOCK_INDEX, si);//make relative to message start
+	setBbPlaceholderBlock(buf, msg, i + STRING_PLACEHOLDER_BLOCK_INDEX, si);//make relative to message start
 	return slen;
 }
 
@@ -265,11 +356,11 @@ uint32_t copyBbStringToMessage(Bb* buf, BbBlock msg, uint16_t i, char* src, uint
  * @param msg - the index of the beginning of the message
  * @param i - the index (in bytes) of the sequence placeholder (which consists of a an index to the sequence length field (uint16) and the element byte count (uint16))
  */
-uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, uint16_t i){
+uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, BbBlock i){
 	//get the index of the block containing the sequence data
-	BbBlock seq = (BbBlock)getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
+	BbBlock seq = getBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX);//this is the index of the sequence block
 	seq += msg;//sequence index is relative to message start so make absolute
-	uint32_t result = getBbUint16(buf, seq, SEQUENCE_BLOCK_ELEMENTS_NUM_INDEX);
+	uint32_t result = getBbUint32(buf, seq, SEQUENCE_BLOCK_ELEMENTS_NUM_INDEX);//the count is 32 bits, as a large packet can hold more than 65535 elements
 	return result;
 }
 /**
@@ -282,16 +373,18 @@ uint32_t getBbSequenceElementNum(Bb* buf, BbBlock msg, uint16_t i){
  * @return the block in the buffer containing the sequence data
 
  */
-BbBlock initBbSequence(Bb* buf, BbBlock msg, uint16_t i, uint32_t elementByteNum, uint32_t elementNum){
+BbBlock initBbSequence(Bb* buf, BbBlock msg, BbBlock i, uint32_t elementByteNum, uint32_t elementNum){
 	BbBlock result;
 	if(elementNum == 0){
 		//if there are zero elements then only set the block index to zero
 		result = BB_INVALID_BLOCK;
 	} else {
 		//determine location to place the sequence block
-		 result = bbAlign(buf->length);//the sequence data will be added to the current end of the buffer
+		 //this is done in 32 bits, as bbAlign() would truncate a packet or sequence past 64 KB
+		 uint32_t start = (buf->length + 3u) & ~3u;//the sequence data will be added to the current end of the buffer
+		 result = (BbBlock)start;
 		 //expand the buffer in preparation for writing the sequence block
-		 buf->length += bbAlign(4 + (elementNum * elementByteNum));
+		 buf->length = start + ((4u + elementNum * elementByteNum + 3u) & ~3u);
 		//record the block index
 		setBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_ELEMENT_LENGTH_INDEX, (uint16_t)elementByteNum);
 		setBbUint32(buf, result, SEQUENCE_BLOCK_ELEMENTS_NUM_INDEX, elementNum);//record the number of elements of this sequence
@@ -300,11 +393,297 @@ BbBlock initBbSequence(Bb* buf, BbBlock msg, uint16_t i, uint32_t elementByteNum
 		updateBbMessageLength(buf, msg);
 		result -= msg;//now make relative to current message
 	}
-	setBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX, (uint16_t)result);//block index is relative to the message start
+	setBbPlaceholderBlock(buf, msg, i + SEQUENCE_PLACEHOLDER_BLOCK_INDEX, result);//block index is relative to the message start
 
 	return result;
 }
 
+/**
+ * copies a run of sequence elements between the buffer and memory
+ * The elements are contiguous in the buffer, so this is done in at most two memcpy() calls, split where the buffer wraps.
+ * The packet is little endian, so on big endian targets each element is swapped on the way.
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to, or NULL if copying to the buffer
+ * @param src - the memory to copy from, or NULL if copying from the buffer
+ * @param n - the number of elements to copy
+ * @param elementByteNum - the number of bytes used by each sequence element
+ * @return the number of elements copied, which will be less than n if the sequence is shorter, and 0 if its elements aren't elementByteNum long
+ */
+static uint32_t copyBbSequence(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, void* dest, const void* src, uint32_t n, uint32_t elementByteNum){
+	uint32_t len = getBbSequenceLength(buf, msg, i);
+	if(first >= len){
+		return 0;
+	}
+	if(getBbUint16(buf, msg, i + SEQUENCE_PLACEHOLDER_ELEMENT_LENGTH_INDEX) != elementByteNum){
+		return 0;//the sequence isn't of this type, so the elements would be misread or overrun it
+	}
+	if(n > len - first){
+		n = len - first;
+	}
+	BbBlock e = getBbSequenceElementIndex(buf, msg, i, first);//relative to the message start
+	if(dest != NULL){
+		getBbBytes(buf, msg, e, (uint8_t*)dest, n * elementByteNum);
+#if BB_BIG_ENDIAN
+		swapBbElements(dest, n, elementByteNum);
+#endif
+	} else {
+#if BB_BIG_ENDIAN
+		//the source can't be swapped in place, so write the elements one at a time with the swapping accessors
+		const uint8_t* s = (const uint8_t*)src;
+		for(uint32_t k = 0; k < n; ++k){
+			BbBlock j = (BbBlock)(e + k*elementByteNum);
+			if(elementByteNum == 4){
+				uint32_t v;
+				memcpy(&v, s, 4);
+				setBbUint32Fast(buf, msg, j, v);
+			} else if(elementByteNum == 2){
+				uint16_t v;
+				memcpy(&v, s, 2);
+				setBbUint16Fast(buf, msg, j, v);
+			} else {
+				setBbUint8Fast(buf, msg, j, *s);
+			}
+			s += elementByteNum;
+		}
+#else
+		setBbBytes(buf, msg, e, (const uint8_t*)src, n * elementByteNum);
+#endif
+	}
+	return n;
+}
+
+#if BB_BIG_ENDIAN
+/**
+ * swaps each element of an array between the little endian order of a packet and the order of the target
+ * @param p - the elements
+ * @param n - the number of elements
+ * @param elementByteNum - the number of bytes in each element
+ */
+static void swapBbElements(void* p, uint32_t n, uint32_t elementByteNum){
+	uint8_t* b = (uint8_t*)p;
+	for(uint32_t k = 0; k < n; ++k){
+		if(elementByteNum == 4){
+			uint32_t v;
+			memcpy(&v, b, 4);
+			v = bbLittleEndian32(v);
+			memcpy(b, &v, 4);
+		} else if(elementByteNum == 2){
+			uint16_t v;
+			memcpy(&v, b, 2);
+			v = bbLittleEndian16(v);
+			memcpy(b, &v, 2);
+		}
+		b += elementByteNum;
+	}
+}
+#endif
+
+/**
+ * copies n 8-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceUint8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint8_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(uint8_t));
+}
+
+/**
+ * copies n 8-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceUint8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint8_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(uint8_t));
+}
+
+/**
+ * copies n 8-bit, signed integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceInt8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int8_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(int8_t));
+}
+
+/**
+ * copies n 8-bit, signed integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceInt8s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int8_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(int8_t));
+}
+
+/**
+ * copies n 16-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceUint16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint16_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(uint16_t));
+}
+
+/**
+ * copies n 16-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceUint16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint16_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(uint16_t));
+}
+
+/**
+ * copies n 16-bit, signed integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceInt16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int16_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(int16_t));
+}
+
+/**
+ * copies n 16-bit, signed integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceInt16s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int16_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(int16_t));
+}
+
+/**
+ * copies n 32-bit, unsigned integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceUint32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, uint32_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(uint32_t));
+}
+
+/**
+ * copies n 32-bit, unsigned integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceUint32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const uint32_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(uint32_t));
+}
+
+/**
+ * copies n 32-bit, signed integers from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceInt32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, int32_t* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(int32_t));
+}
+
+/**
+ * copies n 32-bit, signed integers from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceInt32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const int32_t* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(int32_t));
+}
+
+/**
+ * copies n 32-bit, floating point values from the specified sequence to memory, starting at the specified element
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to copy
+ * @param dest - the memory to copy to
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t getBbSequenceFloat32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, float* dest, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, dest, NULL, n, sizeof(float));
+}
+
+/**
+ * copies n 32-bit, floating point values from memory to the specified sequence, starting at the specified element
+ * The sequence must already have been initialized with initBbSequence()
+ * @param buf - the buffer containing the data packet, message, etc.
+ * @param msg - the index of the beginning of the message
+ * @param i - the index (in bytes) of the sequence placeholder
+ * @param first - the first element to write
+ * @param src - the memory to copy from
+ * @param n - the number of elements to copy
+ * @return the number of elements copied, which will be less than n if the sequence is shorter
+ */
+uint32_t setBbSequenceFloat32s(Bb* buf, BbBlock msg, BbBlock i, uint32_t first, const float* src, uint32_t n){
+	return copyBbSequence(buf, msg, i, first, NULL, src, n, sizeof(float));
+}
+
 /**
  * Gets the specified element of the array, as a block index, relative to the specified message
  * This can be used to read or write from the specified sequence element
@@ -314,7 +693,9 @@ BbBlock initBbSequence(Bb* buf, BbBlock msg, uint16_t i, uint32_t elementByteNum
  * @param arrayElement - the item of the array that we want
  * @param arrayElementLength - the length in bytes of each array element
  */
-BbBlock getBbArrayElementIndex(Bb* buf, BbBlock msg, uint16_t i, uint32_t arrayElement, uint32_t arrayElementLength){
+BbBlock getBbArrayElementIndex(Bb* buf, BbBlock msg, BbBlock i, uint32_t arrayElement, uint32_t arrayElementLength){
+	(void)buf;
+	(void)msg;
 	//if index is invalid then return
 	if(isBbBlockInvalid(i)){
 		return i;
@@ -369,13 +750,11 @@ uint32_t makeBbTopicString(char * target, uint32_t targetMaxLen, char * source,
 	uint32_t j = 0;//the target index
 	uint32_t n = targetMaxLen;//this is the max length of target
 
-	bool notDone = true;
-
 	while(j < n){
 		char c = source[i];
-		if(c == 0x80){
+		if((uint8_t)c == 0x80){
 			j += stringCopy(&target[j], nid, n - j);
-		} else if(c == 0x81){
+		} else if((uint8_t)c == 0x81){
 			j += stringCopy(&target[j], deviceType, n - j);
 		} else if(c == 0x0){
 			target[j] = 0;
@@ -27,24 +27,30 @@ THE SOFTWARE.
 #include <blueberry-parser.h>
 #include <blueberry-receiver.h>
 #include <blueberry-message.h>
+#include <blueberry-crc.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <queue.h>
+#include <string.h>
+#include <crc1021.h>
+#include <ethernet.h>
 
 //*******************************************************************************************
 //Defines
 //*******************************************************************************************
-#define PROCESSOR_NUM (100)
-#define MSG_Q_SIZE (50)
+#define PROCESSOR_NONE (0xffffffff)
+#define DISPATCH_NO_PAGE (0xff)//marks a module that has processors but didn't get a page
 
 #define MAKE_KEY(mod, msg) ((((uint32_t)mod) << 16) | ((uint32_t)msg))
 
 #define PACKET_PREAMBLE (0x65756c42) //(0x45554c42)
+#define PACKET_PREAMBLE_LARGE (0x45756c42)//"BluE", a packet that stores its sequence and string offsets in words. See BB_LARGE_PACKETS
+#define PACKET_LARGE_MIN (0x10000)//the smallest buffer that a large packet is made in
 #define PACKET_PREAMBLE_INDEX (0)
 #define PACKET_LENGTH_INDEX (4)
 #define PACKET_CRC_INDEX (6)
 #define PACKET_FIRST_MESSAGE_INDEX (8)
+#define MESSAGE_HEADER_LENGTH (8)//the key, length and max ordinal at the start of every message
 
 
 
@@ -52,24 +58,13 @@ THE SOFTWARE.
 //*******************************************************************************************
 //Types;
 //*******************************************************************************************
-typedef struct {
-	uint32_t key;
-	BbProcessor parser;
-} ProcessorKeyValue;
-
-typedef struct {
-	ProcessorKeyValue m_processors[PROCESSOR_NUM];
-	uint32_t num;
-} Processors;
+typedef BbProcessorKeyValue ProcessorKeyValue;
+typedef BbProcessors Processors;
 
 //*******************************************************************************************
 //Variables
 //*******************************************************************************************
-static Processors m_parsers;
-static Processors m_builders;
-static uint32_t m_rxQ[MSG_Q_SIZE];
-static uint32_t m_rxQFront = 0;
-static uint32_t m_rxQBack = 0;
+static BbContext m_context;//the context used by the functions that don't take one
 //*******************************************************************************************
 //Function Prototypes
 //*******************************************************************************************
@@ -80,62 +75,330 @@ static uint32_t m_rxQBack = 0;
  * @return - -1 if not found, else the index of the function pointer of the parser
  */
 static BbProcessor lookup(Processors * ps, uint32_t key, uint32_t * index);
-static void registerProcessor(Processors * ps, uint32_t key, BbProcessor p);
+static uint32_t registerProcessor(Processors * ps, uint32_t key, BbProcessor p);
+static BbProcessor findProcessor(Processors * ps, uint32_t key);
+static uint32_t findProcessorSlot(Processors * ps, uint32_t key);
+static BbProcessor getProcessorInSlot(Processors * ps, uint32_t slot);
+static void indexProcessors(Processors * ps);
+static uint32_t searchProcessorTable(const BbProcessorEntry* table, uint32_t num, uint32_t key);
+static const BbMessageLayout* searchLayoutTable(const BbMessageLayout* table, uint32_t num, uint32_t key);
+static bool checkBbMessageLayout(Bb* bb, const BbMessageView* v, const BbMessageLayout* layout);
+static void clearPendingBuilders(BbContext* ctx);
+#if PACK_NUM != 0
+static uint32_t getSizeHintInSlot(BbContext* ctx, uint32_t slot);
+static void packPendingBuilders(BbContext* ctx, uint32_t first, uint32_t capacity);
+#endif
+static uint32_t makeBbPackets(BbContext* ctx, Bb* bb, uint32_t n, BbNextBuffer next, void* context);
 //*******************************************************************************************
 //Code
 //*******************************************************************************************
 /**
  * Must be called at init
+ * This sets up the default context, which is used by the functions that don't take a context, and the UDP listener
  */
 void initBbParser(void){
-	m_parsers.num = 0;
-	m_builders.num = 0;
+	initBbCrc();
+	initBbContext(&m_context);
 	registerUdpListener(BB_UDP_PORT, processBlueberryPacket, false);
 	setEthernetPort(BB_UDP_PORT, BB_UDP_PORT);
 }
 
+/**
+ * sets up a context for an independent blueberry endpoint, with no parsers or builders and nothing queued
+ * Each context has its own dispatch tables, request queue and timing state, so contexts can be used from different threads.
+ * initBbParser() or initBbCrc() must have been called once before any context is used
+ * @param ctx - the context to set up
+ */
+void initBbContext(BbContext* ctx){
+	memset(ctx, 0, sizeof(BbContext));
+#if BB_STATS
+	resetBbStats(&ctx->stats);
+#endif
+	indexProcessors(&ctx->parsers);
+	indexProcessors(&ctx->builders);
+	clearPendingBuilders(ctx);
+}
+
+/**
+ * gets the context used by the functions that don't take one
+ */
+BbContext* getBbDefaultContext(void){
+	return &m_context;
+}
+
+#if BB_STATS
+/**
+ * gets the parse and build counts of the specified context
+ * @param ctx - the context
+ * @return the counts. These can be cleared with resetBbStats()
+ */
+BbStats* getBbStats(BbContext* ctx){
+	return &ctx->stats;
+}
+
+/**
+ * builds a message containing the counts of the default context
+ * This is a builder, so it can be registered with registerBbBuilder(BB_STATS_MESSAGE_KEY, buildBbDefaultStatsMessage)
+ * @param bb - the buffer to build the message in
+ * @param msg - the index of the start of the message
+ */
+void buildBbDefaultStatsMessage(Bb* bb, BbBlock msg){
+	buildBbStatsMessage(bb, msg, BB_STATS_MESSAGE_KEY, &m_context.stats);
+}
+#endif
+
 /**
  * processes a blueberry packet and parses each message
  * This assumes that the buffer has been properly received and is at the start of the packet
  */
 void parseBbPacket(Bb* buf){
+	parseBbPacketCtx(&m_context, buf);
+}
+/**
+ * processes a blueberry packet and parses each message with the parsers of the specified context
+ * Each message is queued in the context so that the response can be made with makeBbPacketWithQueuedMessagesCtx()
+ * @param ctx - the context to use
+ * @param buf - the received packet, at the start of the packet
+ */
+void parseBbPacketCtx(BbContext* ctx, Bb* buf){
 
-	uint32_t packetLength = getBbUint16(buf, 0, PACKET_LENGTH_INDEX)*4;
-	if(packetLength == 0){
-		return;
+	BbMessageIterator it;
+	BbMessageView v;
+	if(ctx->layoutNum > 0){
+		validateBbPacketCtx(ctx, buf);//lets the parsers use the verified accessors
 	}
-	BbBlock msg = PACKET_FIRST_MESSAGE_INDEX;
+	startBbMessageIterator(&it, buf);
 
-	while(msg < packetLength){
+	while(nextBbMessage(&it, &v)){
 		//we have enough data for a message
-		uint32_t k = getBbMessageKey(buf, msg);
-		uint32_t len = getBbMessageLength(buf, msg);
+		BbBlock msg = v.msg;
+		uint32_t k = v.key;
 		//record in the queue that the particular type of message was received
-		queueBbMessage(k);
+		queueBbMessageCtx(ctx, k);
 		if(isBbMessageEmpty(buf, msg)){
 
 		} else {
 
 
-			uint32_t i;
-			BbProcessor p = lookup(&m_parsers, k, &i);
+			BbProcessor p = findProcessor(&ctx->parsers, k);
 			if(p != NULL){
 				//call the parser
+#if BB_STATS
+				uint32_t t = getBbStatsCycles();
+				(*p)(buf, msg);
+				recordBbStats(&ctx->stats, BB_STATS_PARSE, k, v.length, getBbStatsCycles() - t);
+#else
 				(*p)(buf, msg);
+#endif
 			}
+#if BB_STATS
+			else {
+				++ctx->stats.unknownKeys;
+			}
+#endif
+		}
+	}
+}
+/**
+ * starts a walk through the messages of a received packet, without any lookup or copying
+ * This is an alternative to parseBbPacket() for code that wants to forward, filter or inspect the messages itself
+ * @param it - the iterator to start
+ * @param bb - the received packet, at the start of the packet
+ */
+void startBbMessageIterator(BbMessageIterator* it, Bb* bb){
+	uint32_t end = getBbPacketLength(bb);
+	it->bb = bb;
+	it->next = PACKET_FIRST_MESSAGE_INDEX;
+	it->end = end > bb->length ? bb->length : end;//never go past the bytes that were received
+}
+
+/**
+ * gets the next message of the packet
+ * The walk stops at the end of the packet, or at a message whose length is too short or runs past the end of the packet
+ * @param it - the iterator
+ * @param view - set to the next message
+ * @return true if there was another message
+ */
+bool nextBbMessage(BbMessageIterator* it, BbMessageView* view){
+	uint32_t msg = it->next;
+	if(msg + MESSAGE_HEADER_LENGTH > it->end){
+		return false;//not even room for a message header
+	}
+	Bb* bb = it->bb;
+	uint32_t len = getBbMessageLength(bb, (BbBlock)msg);
+	if(len < MESSAGE_HEADER_LENGTH || msg + len > it->end){
+		return false;//the rest of the packet can't be trusted
+	}
+	view->key = getBbMessageKey(bb, (BbBlock)msg);
+	view->msg = (BbBlock)msg;
+	view->length = len;
+	view->maxOrdinal = getBbMessageMaxOrdinal(bb, (BbBlock)msg);
+	it->next = msg + len;
+	return true;
+}
+
+/**
+ * checks the header of every message of a received packet in one pass
+ * The packet is good if its messages exactly fill the length in its header, and all of it has been received
+ * After this, walking the packet with nextBbMessage() will visit every message
+ * @param bb - the received packet, at the start of the packet
+ * @param messageNum - set to the number of good messages before any problem. Can be NULL
+ * @return true if every message header is good
+ */
+bool validateBbMessageHeaders(Bb* bb, uint32_t* messageNum){
+	BbMessageIterator it;
+	BbMessageView v;
+	uint32_t n = 0;
+	startBbMessageIterator(&it, bb);
+	while(nextBbMessage(&it, &v)){
+		++n;
+	}
+	if(messageNum != NULL){
+		*messageNum = n;
+	}
+	//the walk only reaches exactly the end if every message fitted
+	uint32_t len = getBbPacketLength(bb);
+	return len <= bb->length && it.next == len;
+}
+
+/**
+ * sets a constant table of message layouts, sorted by key, so that received packets are validated before they are parsed
+ * This is intended for the autogenerated code, which can place the table in flash.
+ * @param table - the table of layouts, sorted by key. This must remain valid, so should be static
+ * @param num - the number of entries in the table
+ */
+void setBbLayoutTable(const BbMessageLayout* table, uint32_t num){
+	setBbLayoutTableCtx(&m_context, table, num);
+}
+/**
+ * sets a constant table of message layouts, sorted by key, in the specified context. The same table can be shared by many contexts
+ */
+void setBbLayoutTableCtx(BbContext* ctx, const BbMessageLayout* table, uint32_t num){
+	ctx->layouts = table;
+	ctx->layoutNum = num;
+}
+
+/**
+ * checks every message of a received packet against its layout in one pass, and marks the packet as verified if they are all good
+ * @see validateBbPacketCtx()
+ */
+bool validateBbPacket(Bb* bb){
+	return validateBbPacketCtx(&m_context, bb);
+}
+
+/**
+ * checks every message of a received packet against its layout in one pass, and marks the packet as verified if they are all good
+ * The packet is good if it is all received and linear, its messages exactly fill it, and every message has a layout
+ * with all of its fixed fields, sequences and strings inside the message. A message from an older schema, with a lower max ordinal,
+ * or one without a layout, leaves the packet unverified, so that it is parsed with the checked accessors instead.
+ * @param ctx - the context with the layouts
+ * @param bb - the received packet, at the start of the packet
+ * @return true if the packet was verified
+ */
+bool validateBbPacketCtx(BbContext* ctx, Bb* bb){
+	bb->verified = false;
+	uint32_t len = getBbPacketLength(bb);
+	if(len > bb->length || len > bb->linearLength){
+		return false;//the verified accessors don't wrap
+	}
+	BbMessageIterator it;
+	BbMessageView v;
+	startBbMessageIterator(&it, bb);
+	while(nextBbMessage(&it, &v)){
+		const BbMessageLayout* layout = searchLayoutTable(ctx->layouts, ctx->layoutNum, v.key);
+		if(layout == NULL || !checkBbMessageLayout(bb, &v, layout)){
+			return false;
 		}
+	}
+	if(it.next != len){
+		return false;//a message header was bad
+	}
+	bb->verified = true;
+	return true;
+}
 
-		msg += len;
+/**
+ * checks one message against its layout
+ * @param bb - the packet
+ * @param v - the message
+ * @param layout - the layout of the message
+ * @return true if all the fields of the layout are inside the message
+ */
+static bool checkBbMessageLayout(Bb* bb, const BbMessageView* v, const BbMessageLayout* layout){
+	if(v->maxOrdinal < layout->maxOrdinal || v->length < layout->fixedLength){
+		return false;
+	}
+	for(uint32_t k = 0; k < layout->sequenceNum; ++k){
+		if(!checkBbSequenceBlock(bb, v->msg, layout->sequences[k])){
+			return false;
+		}
+	}
+	for(uint32_t k = 0; k < layout->stringNum; ++k){
+		if(!checkBbStringBlock(bb, v->msg, layout->strings[k])){
+			return false;
+		}
+	}
+	return true;
+}
 
+/**
+ * find the layout for the specified key in a constant table
+ * @param table - the table, sorted by key
+ * @param num - the number of entries in the table
+ * @param key - the key to lookup
+ * @return - the layout, or NULL if there isn't one
+ */
+static const BbMessageLayout* searchLayoutTable(const BbMessageLayout* table, uint32_t num, uint32_t key){
+	uint32_t min = 0;
+	uint32_t max = num;//one past the last candidate
+	while(min < max){
+		uint32_t i = min + (max - min) / 2;
+		uint32_t ikey = table[i].key;
+		if(ikey == key){
+			return &table[i];
+		} else if(ikey < key){
+			min = i + 1;
+		} else {
+			max = i;
+		}
 	}
+	return NULL;
 }
+
 /**
  * requests that the next packet should have the message with the specified key added.
+ * Each message is added at most once per packet, however often it is requested. Keys without a builder are ignored.
  * @param key - the module/message key for the desired message
  */
 void queueBbMessage(uint32_t key){
-	m_rxQ[m_rxQBack] = key;
-	justAddedToQueueBack(&m_rxQFront, &m_rxQBack, MSG_Q_SIZE);
+	queueBbMessageCtx(&m_context, key);
+}
+/**
+ * requests that the next packet made with the specified context should have the message with the specified key added.
+ * @param ctx - the context to use
+ * @param key - the module/message key for the desired message
+ */
+void queueBbMessageCtx(BbContext* ctx, uint32_t key){
+	uint32_t slot = findProcessorSlot(&ctx->builders, key);
+	if(slot >= PENDING_NUM){
+		return;//there is no builder for this key so nothing would be added to the packet
+	}
+	uint32_t bit = 1ul << (slot & 31);
+	if(ctx->pendingBits[slot / 32] & bit){
+		return;//already requested
+	}
+	ctx->pendingBits[slot / 32] |= bit;
+	ctx->pendingQ[(ctx->pendingFront + ctx->pendingNum) % PENDING_NUM] = (BbPendingSlot)slot;
+	++ctx->pendingNum;
+}
+
+/**
+ * forgets all requested messages
+ */
+static void clearPendingBuilders(BbContext* ctx){
+	memset(ctx->pendingBits, 0, sizeof(ctx->pendingBits));
+	ctx->pendingFront = 0;
+	ctx->pendingNum = 0;
 }
 
 
@@ -147,20 +410,122 @@ void queueBbMessage(uint32_t key){
  * Will fail silently if the list is full
  */
 void registerBbParser(uint32_t moduleMessageKey, BbProcessor parser){
-	registerProcessor(&m_parsers, moduleMessageKey, parser);
+	registerBbParserCtx(&m_context, moduleMessageKey, parser);
+}
+/**
+ * registers a parser for a given message in the specified context
+ */
+void registerBbParserCtx(BbContext* ctx, uint32_t moduleMessageKey, BbProcessor parser){
+	registerProcessor(&ctx->parsers, moduleMessageKey, parser);
+}
+/**
+ * sets a constant table of parsers, sorted by key. This needs no registration and uses no RAM.
+ * This is intended for the autogenerated code, which can place the table in flash.
+ * Parsers registered with registerBbParser() take precedence over the table
+ * @param table - the table of parsers, sorted by key. This must remain valid, so should be static
+ * @param num - the number of entries in the table
+ */
+void setBbParserTable(const BbProcessorEntry* table, uint32_t num){
+	setBbParserTableCtx(&m_context, table, num);
+}
+/**
+ * sets a constant table of parsers, sorted by key, in the specified context. The same table can be shared by many contexts
+ */
+void setBbParserTableCtx(BbContext* ctx, const BbProcessorEntry* table, uint32_t num){
+	ctx->parsers.table = table;
+	ctx->parsers.tableNum = num;
+}
+/**
+ * sets a constant table of builders, sorted by key. This needs no registration, and the table itself uses no RAM.
+ * This is intended for the autogenerated code, which can place the table in flash.
+ * Builders registered with registerBbBuilder() take precedence over the table
+ * Only the first BUILDER_TABLE_NUM entries are used. Each of those has a pending slot in every context, as a registered
+ * builder does, so a build with a longer table must raise BUILDER_TABLE_NUM
+ * @param table - the table of builders, sorted by key. This must remain valid, so should be static
+ * @param num - the number of entries in the table
+ * @return false if the table was longer than BUILDER_TABLE_NUM, and so was cut short
+ */
+bool setBbBuilderTable(const BbProcessorEntry* table, uint32_t num){
+	return setBbBuilderTableCtx(&m_context, table, num);
+}
+/**
+ * sets a constant table of builders, sorted by key, in the specified context. The same table can be shared by many contexts
+ * @see setBbBuilderTable()
+ */
+bool setBbBuilderTableCtx(BbContext* ctx, const BbProcessorEntry* table, uint32_t num){
+	bool result = num <= BUILDER_TABLE_NUM;
+	ctx->builders.table = table;
+	ctx->builders.tableNum = result ? num : BUILDER_TABLE_NUM;//entries past the pending slots could never be queued
+	clearPendingBuilders(ctx);//the pending slots refer to the old table
+	return result;
 }
 /**
  * register a message processor for adding a message to a buffer
  */
 void registerBbBuilder(uint32_t moduleMessageKey, BbProcessor builder){
-	registerProcessor(&m_builders, moduleMessageKey, builder);
+	registerBbBuilderCtx(&m_context, moduleMessageKey, builder);
+}
+/**
+ * register a message processor for adding a message to a buffer in the specified context
+ */
+void registerBbBuilderCtx(BbContext* ctx, uint32_t moduleMessageKey, BbProcessor builder){
+	uint32_t i = registerProcessor(&ctx->builders, moduleMessageKey, builder);
+#if PACK_NUM != 0
+	if(i != PROCESSOR_NONE){
+		//keep the size hints in step with the builders
+		for(uint32_t j = ctx->builders.num - 1; j > i; --j){
+			ctx->hints[j] = ctx->hints[j - 1];
+		}
+		ctx->hints[i].fixedLength = 0;//the size of a new builder isn't known yet
+		ctx->hints[i].variableLength = NULL;
+	}
+#else
+	(void)i;
+#endif
+	clearPendingBuilders(ctx);//registering may move builders to different slots
+}
+
+/**
+ * gives the size of the message made by a registered builder, so that queued messages can be packed into as few packets as possible
+ * The builder must already be registered. Builders in a constant table have their size hints in the table instead
+ * @param moduleMessageKey - the module/message key of the builder
+ * @param fixedLength - the number of bytes of the message that don't depend on the data, including the header
+ * @param variableLength - estimates the rest of the message at the time it is built, or NULL if there isn't any
+ */
+void setBbBuilderSizeHint(uint32_t moduleMessageKey, uint32_t fixedLength, BbSizeHint variableLength){
+	setBbBuilderSizeHintCtx(&m_context, moduleMessageKey, fixedLength, variableLength);
+}
+/**
+ * gives the size of the message made by a builder registered in the specified context
+ */
+void setBbBuilderSizeHintCtx(BbContext* ctx, uint32_t moduleMessageKey, uint32_t fixedLength, BbSizeHint variableLength){
+#if PACK_NUM != 0
+	uint32_t i;
+	if(lookup(&ctx->builders, moduleMessageKey, &i) != NULL){
+		ctx->hints[i].fixedLength = fixedLength;
+		ctx->hints[i].variableLength = variableLength;
+	}
+#else
+	(void)ctx;
+	(void)moduleMessageKey;
+	(void)fixedLength;
+	(void)variableLength;
+#endif
 }
 
-static void registerProcessor(Processors * ps, uint32_t key, BbProcessor p){
+/**
+ * adds a processor for the specified key, or replaces the one already there
+ * @param ps - the processors struct to add to
+ * @param key - the module/message key
+ * @param p - the processor
+ * @return the index of the processor if it was added, or PROCESSOR_NONE if it replaced one or there was no room
+ */
+static uint32_t registerProcessor(Processors * ps, uint32_t key, BbProcessor p){
 
 	if(ps->num >= PROCESSOR_NUM){
-		return;
+		return PROCESSOR_NONE;
 	}
+	uint32_t result = PROCESSOR_NONE;
 	uint32_t i;
 	uint32_t k = key;
 	BbProcessor pt = lookup(ps, k, &i);
@@ -168,15 +533,169 @@ static void registerProcessor(Processors * ps, uint32_t key, BbProcessor p){
 		//we didn't find a match so make room by
 		//moving everything up one, from the ith location to the end
 		for(uint32_t j = ps->num; j > i; --j){
-			ProcessorKeyValue * kvNew = &(ps->m_processors[j]);
-			ProcessorKeyValue * kvOld = &(ps->m_processors[j - 1]);
-			kvNew->key = kvOld->key;
-			kvNew->parser = kvOld->parser;
+			ps->m_processors[j] = ps->m_processors[j - 1];
 		}
 		++ps->num;//we now have one more parser
+		result = i;
 	}
 	ps->m_processors[i].key = k;
 	ps->m_processors[i].parser = p;
+	indexProcessors(ps);
+	return result;
+}
+
+/**
+ * find the processor that is assigned to the specified key
+ * @param ps - the processors struct to look in
+ * @param key - the key to lookup
+ * @return - the processor, or NULL if there isn't one
+ */
+static BbProcessor findProcessor(Processors * ps, uint32_t key){
+	return getProcessorInSlot(ps, findProcessorSlot(ps, key));
+}
+
+/**
+ * find the slot of the processor that is assigned to the specified key
+ * Registered processors are in slots 0 to PROCESSOR_NUM - 1, and entries of the constant table follow them.
+ * Keys with a small module and message ID are found in constant time with the module->message index, if it is built in.
+ * A module with no processors is rejected straight away. Any other key falls back to the binary search.
+ * If no processor was registered for the key then the constant table is searched, if there is one.
+ * @param ps - the processors struct to look in
+ * @param key - the key to lookup
+ * @return - the slot, or PROCESSOR_NONE if there isn't one
+ */
+static uint32_t findProcessorSlot(Processors * ps, uint32_t key){
+	uint32_t result = PROCESSOR_NONE;
+#if DISPATCH_PAGE_NUM != 0
+	uint32_t mod = key >> 16;
+	uint32_t msg = key & 0xffff;
+	if(mod < DISPATCH_MODULE_NUM && ps->pageOfModule[mod] == 0){
+		//nothing registered for this module
+	} else if(mod < DISPATCH_MODULE_NUM && ps->pageOfModule[mod] != DISPATCH_NO_PAGE && msg < DISPATCH_PAGE_SIZE){
+		uint32_t slot = ps->pages[ps->pageOfModule[mod] - 1][msg];
+		if(slot != 0){
+			result = slot - 1;
+		}
+	} else
+#endif
+	{
+		uint32_t i;
+		if(lookup(ps, key, &i) != NULL){
+			result = i;
+		}
+	}
+	if(result == PROCESSOR_NONE && ps->tableNum != 0){
+		uint32_t i = searchProcessorTable(ps->table, ps->tableNum, key);
+		if(i != PROCESSOR_NONE){
+			result = PROCESSOR_NUM + i;
+		}
+	}
+	return result;
+}
+
+/**
+ * gets the processor in the specified slot
+ * @param ps - the processors struct to look in
+ * @param slot - the slot, as found by findProcessorSlot()
+ * @return - the processor, or NULL if there isn't one
+ */
+static BbProcessor getProcessorInSlot(Processors * ps, uint32_t slot){
+	BbProcessor result = NULL;
+	if(slot < PROCESSOR_NUM){
+		result = ps->m_processors[slot].parser;
+	} else if(slot != PROCESSOR_NONE && slot - PROCESSOR_NUM < ps->tableNum){
+		result = ps->table[slot - PROCESSOR_NUM].processor;
+	}
+	return result;
+}
+
+#if PACK_NUM != 0
+/**
+ * estimates the size of the message made by the builder in the specified slot
+ * @param ctx - the context with the builders
+ * @param slot - the slot, as found by findProcessorSlot()
+ * @return - the number of bytes the message will take, rounded up to a whole word, or 0 if it isn't known
+ */
+static uint32_t getSizeHintInSlot(BbContext* ctx, uint32_t slot){
+	Processors* ps = &ctx->builders;
+	uint32_t fixed = 0;
+	BbSizeHint variable = NULL;
+	uint32_t key = 0;
+	if(slot < PROCESSOR_NUM){
+		fixed = ctx->hints[slot].fixedLength;
+		variable = ctx->hints[slot].variableLength;
+		key = ps->m_processors[slot].key;
+	} else if(slot != PROCESSOR_NONE && slot - PROCESSOR_NUM < ps->tableNum){
+		fixed = ps->table[slot - PROCESSOR_NUM].fixedLength;
+		variable = ps->table[slot - PROCESSOR_NUM].variableLength;
+		key = ps->table[slot - PROCESSOR_NUM].key;
+	}
+	if(fixed == 0){
+		return 0;
+	}
+	uint32_t n = fixed + (variable != NULL ? (*variable)(key) : 0);
+	return n > 0xfffc ? 0xfffc : ((n + 3) & ~((uint32_t)0b11));
+}
+#endif
+
+/**
+ * find the processor for the specified key in a constant table
+ * @param table - the table, sorted by key
+ * @param num - the number of entries in the table
+ * @param key - the key to lookup
+ * @return - the index of the entry, or PROCESSOR_NONE if there isn't one
+ */
+static uint32_t searchProcessorTable(const BbProcessorEntry* table, uint32_t num, uint32_t key){
+	uint32_t min = 0;
+	uint32_t max = num;//one past the last candidate
+	while(min < max){
+		uint32_t i = min + (max - min) / 2;
+		uint32_t ikey = table[i].key;
+		if(ikey == key){
+			return i;
+		} else if(ikey < key){
+			min = i + 1;
+		} else {
+			max = i;
+		}
+	}
+	return PROCESSOR_NONE;
+}
+
+/**
+ * rebuilds the module->message index of the specified processors
+ * This is only done when a processor is registered, so it doesn't need to be quick
+ * @param ps - the processors struct to index
+ */
+static void indexProcessors(Processors * ps){
+#if DISPATCH_PAGE_NUM != 0
+	memset(ps->pageOfModule, 0, sizeof(ps->pageOfModule));
+	ps->pageNum = 0;
+	for(uint32_t i = 0; i < ps->num; ++i){
+		uint32_t key = ps->m_processors[i].key;
+		uint32_t mod = key >> 16;
+		uint32_t msg = key & 0xffff;
+		if(mod >= DISPATCH_MODULE_NUM){
+			continue;
+		}
+		uint32_t page = ps->pageOfModule[mod];
+		if(page == 0){
+			//first processor of this module, so give it a page if there are any left
+			if(ps->pageNum < DISPATCH_PAGE_NUM){
+				page = ++ps->pageNum;
+				memset(ps->pages[page - 1], 0, sizeof(ps->pages[0]));
+			} else {
+				page = DISPATCH_NO_PAGE;
+			}
+			ps->pageOfModule[mod] = (uint8_t)page;
+		}
+		if(page != DISPATCH_NO_PAGE && msg < DISPATCH_PAGE_SIZE){
+			ps->pages[page - 1][msg] = (BbDispatchSlot)(i + 1);
+		}
+	}
+#else
+	(void)ps;
+#endif
 }
 
 
@@ -248,19 +767,91 @@ bool checkBbPreamble(Bb* bb){
 	for(uint32_t j = 0; j < n; ++j){
 		a |= ((uint32_t)getBbUint8(bb, 0, PACKET_PREAMBLE_INDEX + j)) << (j*8);
 	}
+#if BB_LARGE_PACKETS
+	if(a == (PACKET_PREAMBLE_LARGE & (0xffffffff >> ((4 - n)*8)))){
+		return true;
+	}
+#endif
 
 
 	return (a ^ b) == 0;
 }
+/**
+ * finds the next place in the received bytes, at or after the specified index, where a packet could start
+ * This is used to resynchronise after a bad packet without throwing away a good preamble that follows it.
+ * Candidates for the first preamble byte are found with memchr() on the contiguous parts of the buffer,
+ * so the whole search is a single pass. A partial preamble at the end of the received bytes also counts.
+ * @param bb - the buffer containing the received bytes
+ * @param from - the index to start searching at
+ * @return the index of the start of the preamble, or the buffer length if there isn't one
+ */
+uint32_t findBbPreamble(Bb* bb, uint32_t from){
+	const uint8_t first = (uint8_t)(PACKET_PREAMBLE & 0xff);
+	uint32_t n = bb->length;
+	uint32_t i = from;
+	while(i < n){
+		//search the part of the buffer from i to either the end of the packet or the end of the buffer
+		uint32_t j = bbWrap(bb, i);
+		uint32_t m = bb->bufferLength - j;
+		if(m > n - i){
+			m = n - i;
+		}
+		const uint8_t* p = memchr(&bb->buffer[j], first, m);
+		if(p == NULL){
+			i += m;
+			continue;
+		}
+		i += (uint32_t)(p - &bb->buffer[j]);
+		//now check the rest of the preamble, as much of it as there is
+		bool match = true;
+		for(uint32_t k = 1; k < 4 && i + k < n; ++k){
+			uint8_t c = getBbUint8(bb, i, PACKET_PREAMBLE_INDEX + k);
+			if(c != (uint8_t)(PACKET_PREAMBLE >> (k*8))
+#if BB_LARGE_PACKETS
+					&& c != (uint8_t)(PACKET_PREAMBLE_LARGE >> (k*8))
+#endif
+					){
+				match = false;
+				break;
+			}
+		}
+		if(match){
+			return i;
+		}
+		++i;
+	}
+	return n;
+}
 /**
  * a function to test the length of the received packet so far. It should return true when enough bytes have been received
  */
 bool checkBbLength(Bb* bb){
-	uint32_t len = getBbUint16(bb, 0, PACKET_LENGTH_INDEX)*4;
+	uint32_t len = getBbPacketLength(bb);
 	uint32_t n = bb->length;
 
 	return n >= PACKET_FIRST_MESSAGE_INDEX && n >= len;
 }
+/**
+ * tests if the packet stores its sequence and string offsets in words, so that they can reach past 64KB
+ * Large packets are only made and understood when built with BB_LARGE_PACKETS. Other builds treat them as a bad preamble
+ * @param bb - the packet. The preamble must have been received or written
+ * @return true if the packet has the large preamble
+ */
+bool isBbPacketLarge(Bb* bb){
+#if BB_LARGE_PACKETS
+	return getBbUint8Fast(bb, 0, PACKET_PREAMBLE_INDEX + 3) == (uint8_t)(PACKET_PREAMBLE_LARGE >> 24);
+#else
+	(void)bb;
+	return false;
+#endif
+}
+/**
+ * gets the length of the packet in bytes, as recorded in the packet header
+ * This is only meaningful once the header has been received
+ */
+uint32_t getBbPacketLength(Bb* bb){
+	return (uint32_t)getBbUint16(bb, 0, PACKET_LENGTH_INDEX)*4;
+}
 /**
  * a function to check the CRC of the received bytes. It will return true with a correct match
  */
@@ -271,12 +862,55 @@ bool checkBbCrc(Bb* bb){
 	return crcA == crcB;
 }
 
+/**
+ * resets the running crc that is kept while a packet is being received
+ * @param bb - the buffer that the packet is being received into
+ */
+void resetBbRunningCrc(Bb* bb){
+	bb->crcLength = PACKET_FIRST_MESSAGE_INDEX;
+	resetCrc1021P(&bb->crc);
+}
+
+/**
+ * folds any whole words received since the last call into the running crc
+ * This only reads the new bytes, so the cost is spread over the calls that receive the packet
+ * @param bb - the buffer that the packet is being received into
+ */
+void updateBbRunningCrc(Bb* bb){
+	uint32_t n = bb->length & ~((uint32_t)0b11);
+	if(n > bb->crcLength){
+		bb->crc = foldBbCrc(bb, bb->crc, bb->crcLength, n);
+		bb->crcLength = n;
+	}
+}
+
+/**
+ * a function to check the running CRC of the received bytes. It will return true with a correct match
+ * The bytes of the packet should have been folded in by updateBbRunningCrc() as they arrived
+ * @param bb - the buffer that the packet was received into
+ */
+bool checkBbRunningCrc(Bb* bb){
+	updateBbRunningCrc(bb);
+	uint16_t crcA = (uint16_t)getBbUint16(bb, 0, PACKET_CRC_INDEX);
+	uint16_t crcB = bb->crc;
+	getCrc1021P(&crcB);
+	return bb->crcLength == bb->length && crcA == crcB;
+}
+
 /**
  * does any preliminary header setup and computes the location for the starting message
+ * With BB_LARGE_PACKETS, a buffer of 64KB or more gets a large packet, so that it can all be used. Smaller ones get a normal packet
  */
 BbBlock startBbPacket(Bb* bb){
 	bb->length = PACKET_FIRST_MESSAGE_INDEX;
-	setBbUint32(bb, 0, 0, PACKET_PREAMBLE);
+	updateBbLinear(bb);
+	uint32_t preamble = PACKET_PREAMBLE;
+#if BB_LARGE_PACKETS
+	if(bb->bufferLength >= PACKET_LARGE_MIN){
+		preamble = PACKET_PREAMBLE_LARGE;
+	}
+#endif
+	setBbUint32Fast(bb, 0, 0, preamble);
 //	setBbUint16(bb, 0, PACKET_CRC_INDEX, 0xffff);
 //	setBbUint16(bb, 0, PACKET_LENGTH_INDEX, 0);
 
@@ -287,6 +921,7 @@ BbBlock startBbPacket(Bb* bb){
  */
 void undoBbPacketStart(Bb* bb){
 	bb->length = 0;
+	updateBbLinear(bb);
 }
 /**
  * Finalize the packet in preparation for sending
@@ -294,56 +929,244 @@ void undoBbPacketStart(Bb* bb){
  * And all messages construted correctly
  */
 void finishBbPacket(Bb* bb){
-	uint32_t n = bbAlign(bb->length);
+	uint32_t n = (bb->length + 3u) & ~3u;//not bbAlign(), which would truncate a length past the end of a small block
+	updateBbLinear(bb);
 //	setBbUint32(bb, 0, 0, PACKET_PREAMBLE);
-	setBbUint16(bb, 0, PACKET_LENGTH_INDEX, (uint16_t)(n/4));
+	setBbUint16Fast(bb, 0, PACKET_LENGTH_INDEX, (uint16_t)(n/4));
 	uint16_t crc = computeCrc(bb, PACKET_FIRST_MESSAGE_INDEX, n);
-	setBbUint16(bb, 0, PACKET_CRC_INDEX, crc);
+	setBbUint16Fast(bb, 0, PACKET_CRC_INDEX, crc);
 }
 
 /**
  * indicates that messages were received and should trigger a corresponding packet of messages to be sent
  */
 bool isBbPacketRequested(){
-	return isQueueNotEmpty(&m_rxQFront, &m_rxQBack, MSG_Q_SIZE);
+	return isBbPacketRequestedCtx(&m_context);
+}
+/**
+ * indicates that messages were received by the specified context and should trigger a packet of messages to be sent
+ */
+bool isBbPacketRequestedCtx(BbContext* ctx){
+	return ctx->pendingNum != 0;
 }
 
 /**
  * Make a packet in the specified buffer that contains all queued messages
  * Note that a packet may not be fully completed, in which case the buffer will still have a length of zero
+ * Any messages that don't fit in the buffer are dropped, as the next packet may be a response to someone else
  * @param bb - the buffer to make the packet in
 
  */
 void makeBbPacketWithQueuedMessages(Bb* bb){
+	makeBbPacketsWithQueuedMessagesCtx(&m_context, bb, NULL, NULL);
+}
+/**
+ * Make a packet in the specified buffer that contains all messages queued in the specified context
+ */
+void makeBbPacketWithQueuedMessagesCtx(BbContext* ctx, Bb* bb){
+	makeBbPacketsWithQueuedMessagesCtx(ctx, bb, NULL, NULL);
+}
+/**
+ * Make a packet in the specified buffer that contains the queued messages, taking at most n bytes
+ * @see makeBbPacketWithQueuedMessagesNCtx()
+ */
+void makeBbPacketWithQueuedMessagesN(Bb* bb, uint32_t n){
+	makeBbPacketWithQueuedMessagesNCtx(&m_context, bb, n);
+}
+/**
+ * Make a packet in the specified buffer that contains the messages queued in the specified context, taking at most n bytes
+ * This is for a buffer that the packet can only have part of, such as the free space of a queue.
+ * Any messages that don't fit in n bytes are left queued for the next packet, so this is only for a link with one
+ * peer, such as a UART, where the next packet goes to the same requester
+ * @param ctx - the context with the queued messages
+ * @param bb - the buffer to make the packet in
+ * @param n - the most bytes that the packet may take. No more than the buffer length is used either way
+ */
+void makeBbPacketWithQueuedMessagesNCtx(BbContext* ctx, Bb* bb, uint32_t n){
+	makeBbPackets(ctx, bb, n, NULL, NULL);
+}
+
+#if PACK_NUM != 0
+/**
+ * reorders the pending builders so that building them in order fills as few packets as possible
+ * The messages with a size hint are packed first fit, biggest first, and are then queued one packet after another.
+ * The packets are filled in order, so a message only goes in a later packet if it didn't fit in the earlier ones.
+ * The messages without a size hint follow, in the order they were requested.
+ * The estimates don't need to be exact, as makeBbPacketsWithQueuedMessages() still checks that each message fits
+ * @param ctx - the context with the pending builders
+ * @param first - the number of bytes of the first packet available for messages
+ * @param capacity - the number of bytes of each later packet available for messages
+ */
+static void packPendingBuilders(BbContext* ctx, uint32_t first, uint32_t capacity){
+	uint32_t n = ctx->pendingNum;
+	uint32_t sized = 0;
+	uint32_t unsized = 0;
+	first = first > 0xfffc ? 0xfffc : first;
+	capacity = capacity > 0xfffc ? 0xfffc : capacity;
+	//sort the messages with a size hint by decreasing size, keeping the requested order between equal sizes
+	for(uint32_t i = 0; i < n; ++i){
+		BbPendingSlot slot = ctx->pendingQ[(ctx->pendingFront + i) % PENDING_NUM];
+		uint16_t size = (uint16_t)getSizeHintInSlot(ctx, slot);
+		if(size == 0){
+			ctx->packSlot[n - 1 - unsized++] = slot;//these are kept at the end, last first
+			continue;
+		}
+		uint32_t j = sized++;
+		while(j > 0 && ctx->packSize[j - 1] < size){
+			ctx->packSlot[j] = ctx->packSlot[j - 1];
+			ctx->packSize[j] = ctx->packSize[j - 1];
+			--j;
+		}
+		ctx->packSlot[j] = slot;
+		ctx->packSize[j] = size;
+	}
+	if(sized < 2){
+		return;//nothing to gain
+	}
+	//put each in the first packet it fits in
+	uint32_t bins = 0;
+	for(uint32_t i = 0; i < sized; ++i){
+		uint32_t b = 0;
+		while(b < bins && ctx->packFree[b] < ctx->packSize[i]){
+			++b;
+		}
+		if(b == bins){
+			uint32_t c = bins == 0 ? first : capacity;
+			ctx->packFree[bins++] = (uint16_t)(ctx->packSize[i] > c ? 0 : c - ctx->packSize[i]);
+		} else {
+			ctx->packFree[b] -= ctx->packSize[i];
+		}
+		ctx->packBin[i] = (uint16_t)b;
+	}
+	//requeue packet by packet
+	uint32_t k = 0;
+	for(uint32_t b = 0; b < bins; ++b){
+		for(uint32_t i = 0; i < sized; ++i){
+			if(ctx->packBin[i] == b){
+				ctx->pendingQ[k++] = ctx->packSlot[i];
+			}
+		}
+	}
+	//the messages without a size hint go at the end, in the order they were requested
+	for(uint32_t i = 0; i < unsized; ++i){
+		ctx->pendingQ[k++] = ctx->packSlot[n - 1 - i];
+	}
+	ctx->pendingFront = 0;
+}
+#endif
+
+/**
+ * Make as many packets as needed to hold all queued messages, each no bigger than the buffer
+ * Messages with size hints are packed first, so that as few packets as possible are made (see packPendingBuilders())
+ * If a message doesn't fit then it is rolled back, the packet is finished and handed to next(), and the message is
+ * built again at the start of the next packet. A message too big for an empty packet is dropped.
+ * Every packet but the last is handed to next(). The last one is left in the buffer, as with makeBbPacketWithQueuedMessages()
+ * Messages that don't fit once next() is NULL or returns false are dropped, so they aren't sent to the next requester
+ * @param bb - the buffer to make the first packet in
+ * @param next - the function to send a full packet and provide a new buffer. If NULL then only one packet is made
+ * @param context - passed to next()
+ * @return the number of packets made
+ */
+uint32_t makeBbPacketsWithQueuedMessages(Bb* bb, BbNextBuffer next, void* context){
+	return makeBbPacketsWithQueuedMessagesCtx(&m_context, bb, next, context);
+}
+/**
+ * Make as many packets as needed to hold all messages queued in the specified context
+ * @see makeBbPacketsWithQueuedMessages()
+ * @param ctx - the context with the queued messages
+ * @param bb - the buffer to make the first packet in
+ * @param next - the function to send a full packet and provide a new buffer. If NULL then only one packet is made
+ * @param context - passed to next()
+ * @return the number of packets made
+ */
+uint32_t makeBbPacketsWithQueuedMessagesCtx(BbContext* ctx, Bb* bb, BbNextBuffer next, void* context){
+	uint32_t result = makeBbPackets(ctx, bb, bb->bufferLength, next, context);
+	//the next request may come from a different peer, so anything that wasn't sent to this one is dropped
+	clearPendingBuilders(ctx);
+	return result;
+}
+
+/**
+ * Make as many packets as needed to hold all messages queued in the specified context
+ * @see makeBbPacketsWithQueuedMessages()
+ * @param ctx - the context with the queued messages
+ * @param bb - the buffer to make the first packet in
+ * @param n - the most bytes that the first packet may take. The packets in the buffers from next() can fill them
+ * @param next - the function to send a full packet and provide a new buffer. If NULL then only one packet is made
+ * @param context - passed to next()
+ * @return the number of packets made
+ */
+static uint32_t makeBbPackets(BbContext* ctx, Bb* bb, uint32_t n, BbNextBuffer next, void* context){
 	bool started = false;
+	uint32_t result = 0;
 	BbBlock msg = PACKET_FIRST_MESSAGE_INDEX;
+	uint32_t limit = n < bb->bufferLength ? n : bb->bufferLength;
+	if(limit <= PACKET_FIRST_MESSAGE_INDEX){
+		return 0;//there isn't room for any message, so leave them all queued
+	}
 
-	while(isQueueNotEmpty(&m_rxQFront, &m_rxQBack, MSG_Q_SIZE)){
-		uint32_t key = m_rxQ[m_rxQFront];
-		doneWithQueueFront(&m_rxQFront, &m_rxQBack, MSG_Q_SIZE);
-		uint32_t i = 0;
-		BbProcessor p = lookup(&m_builders, key, &i);
+#if PACK_NUM != 0
+	//the first packet may only have part of the buffer, and the later ones are assumed to be the same size as the buffer
+	if(ctx->pendingNum <= PACK_NUM){
+		packPendingBuilders(ctx, limit - PACKET_FIRST_MESSAGE_INDEX, bb->bufferLength - PACKET_FIRST_MESSAGE_INDEX);
+	}
+#endif
+	while(ctx->pendingNum != 0){
+		uint32_t slot = ctx->pendingQ[ctx->pendingFront];
+		BbProcessor p = getProcessorInSlot(&ctx->builders, slot);
 		if(p != NULL){
 			if(!started){
 				startBbPacket(bb);
 				started = true;
 			}
 			msg = bb->length;//point to the next free byte of the buffer
+#if BB_STATS
+			uint32_t t = getBbStatsCycles();
+#endif
 			(*p)(bb, msg);
+#if BB_STATS
+			t = getBbStatsCycles() - t;
+#endif
 
+			if(((bb->length + 3u) & ~3u) > limit){//in 32 bits, so a message that runs far past the buffer can't wrap round to fit
+				//the message didn't fit so roll it back
+				//anything written past the end of the buffer was dropped, so the rest of the packet is intact
+				uint32_t needed = bb->length;
+				bb->length = msg;
+				if(msg > PACKET_FIRST_MESSAGE_INDEX){
+					finishBbPacket(bb);
+					++result;
+					started = false;
+					if(next == NULL || !(*next)(bb, context)){
+						return result;//leave this message queued
+					}
+					limit = bb->bufferLength;
+					continue;//try this message again in the new packet
+				}
+				if(needed <= bb->bufferLength){
+					//it would fit if the packet could have the whole buffer, so leave it queued until there is room
+					undoBbPacketStart(bb);
+					return result;
+				}
+				//this message won't fit even in an empty packet so give up on it
+			}
+#if BB_STATS
+			else {
+				recordBbStats(&ctx->stats, BB_STATS_BUILD, getBbMessageKey(bb, msg), bb->length - msg, t);
+			}
+#endif
 		}
-
-
-
+		ctx->pendingFront = (ctx->pendingFront + 1) % PENDING_NUM;
+		--ctx->pendingNum;
+		ctx->pendingBits[slot / 32] &= ~(1ul << (slot & 31));
 	}
 	if(started && bb->length > PACKET_FIRST_MESSAGE_INDEX){
 		finishBbPacket(bb);
+		++result;
 	} else {
 		undoBbPacketStart(bb);
 	}
-
-
-
+	return result;
 }
 
 /**
@@ -351,7 +1174,7 @@ void makeBbPacketWithQueuedMessages(Bb* bb){
  * this is useful to compute the next greater index that is word-aligned
  * or to round up a message length to the nearest 4-bytes
  */
-BbBlock bbAlign(uint16_t i){
+BbBlock bbAlign(BbBlock i){
 	BbBlock result = i;
 
 	if(i & 0b11){
@@ -27,9 +27,11 @@ THE SOFTWARE.
 #include <blueberry-receiver.h>
 #include <blueberry-transcoder.h>
 #include <blueberry-parser.h>
+#include <blueberry-ring.h>
 #include <ethernet.h>
 
 #include <stddef.h>
+#include <string.h>
 
 #include <timeSync.h>
 //#include <fastcodeUtil.h>
@@ -43,13 +45,20 @@ THE SOFTWARE.
 //*******************************************************************************************
 //Types
 //*******************************************************************************************
+/**
+ * where to send the packets of a UDP response
+ */
+typedef struct {
+	uint8_t* mac;//the mac address of the requester
+	uint32_t ip;//the IP address of the requester
+	uint16_t port;//the port of the requester
+	uint8_t* data;//the payload of the UDP packet currently being built
+} UdpResponse;
 
 //*******************************************************************************************
 //Variables
 //*******************************************************************************************
 
-static uint32_t m_lastRxTime = 0;
-
 //*******************************************************************************************
 //Function Prototypes
 //*******************************************************************************************
@@ -61,9 +70,10 @@ static uint32_t m_lastRxTime = 0;
  * This function will discard the queue contents if the packet fails the checks
  * This is implemented with function pointers. I tried to avoid them but it allows easy inclusion into the autogenerated code
  * @param buf - the buffer for this packet, also the state of the receive routine
+ * @param link - the health counters of the link
  * @return true if a valid packet was received
  */
-static bool blueberryReceivePacket(Bb* buf);
+static bool blueberryReceivePacket(Bb* buf, BbLinkStats* link);
 /**
  * Receive n bytes from the queue.
  * If the queue has less than n bytes available, then only use what is available.
@@ -72,9 +82,20 @@ static bool blueberryReceivePacket(Bb* buf);
  * @param s - state for this routine to allow for multiple calls
  * @param q - the queue that the new bytes are coming from
  * @param n - the maximum number of bytes to process - this is to limit the type that this routine will take at one calling
+ * @param link - the health counters of the link
  *
  */
-static bool blueberryReceive(Bb* bb, ByteQ* q, uint32_t n);
+static bool blueberryReceive(Bb* bb, ByteQ* q, uint32_t n, BbLinkStats* link);
+static void countBbLink(atomic_uint_fast32_t* counter, uint32_t n);
+static bool sendBbResponse(BbContext* ctx, ByteQ* outQ);
+/**
+ * sends a full packet of a UDP response and starts a new UDP packet for the rest of the response
+ * This matches the function signature of @see BbNextBuffer
+ * @param bb - the buffer containing the full packet
+ * @param context - the UdpResponse
+ * @return true if a new packet was started
+ */
+static bool nextUdpResponsePacket(Bb* bb, void* context);
 //*******************************************************************************************
 //Code
 //*******************************************************************************************
@@ -84,23 +105,30 @@ static bool blueberryReceive(Bb* bb, ByteQ* q, uint32_t n);
  * If the queue has less than n bytes available, then only use what is available.
  * This is intended for use with a UART
  * This function will test the CRC
- * This function will discard bytes from the queue if they are bad
+ * This function will discard bytes from the queue if they are bad, up to the next preamble
  * This is implemented with function pointers. I tried to avoid them but it allows easy inclusion into the autogenerated code
  * the length field of the Bb packet field is used as a state variable. Zero indicates the state is reset. After that it indicates how many bytes have been successfully received
+ * the crc of the packet is kept up to date as bytes arrive so that checking it at the end of the packet is quick
+ * once the header has arrived the packet is only checked for completion once per call, so the cost depends on the number of calls, not bytes
  * @param buf - the buffer for this packet, also the state of the receive routine
  * @param q - the queue that the new bytes are coming from
  * @param n - the maximum number of bytes to process - this is to limit the type that this routine will take at one calling
+ * @param link - the health counters of the link, which count every byte that is thrown away and why
  * @return true if a valid packet was received
  *
  */
-static bool blueberryReceive(Bb* buf, ByteQ* q, uint32_t n){
+static bool blueberryReceive(Bb* buf, ByteQ* q, uint32_t n, BbLinkStats* link){
 	bool result = false;
 	bool fail = false;
 	if( buf->length == 0){
 		buf->buffer = q->buffer;
 		buf->bufferLength = q->bufferSize;
+		buf->mirrorLength = getBbRingMirror(q->buffer, q->bufferSize);
+		buf->writeLimit = 0;
 		buf->start = q->front;
 		buf->time = getLocalTimeMillis();
+		updateBbLinear(buf);
+		resetBbRunningCrc(buf);
 	}
 	//figure out how many bytes to receive
 	//note that any new bytes will be the difference between the size of bb and the amount on the queue
@@ -109,31 +137,63 @@ static bool blueberryReceive(Bb* buf, ByteQ* q, uint32_t n){
 		m = n;
 	}
 
-	//cycle through all the bytes so far
-	for(uint32_t i = 0; i < m; ++i){
-
-		++(buf->length);
+	//cycle through the new bytes
+	//the header is taken a byte at a time so the preamble can be checked as it arrives
+	//after that the header says how long the packet is, so jump straight to the end of the packet or the available bytes
+	while(m > 0){
+		uint32_t step = 1;
+		if(minBbLengthCheck(buf)){
+			uint32_t len = getBbPacketLength(buf);
+			if(len > buf->length){
+				step = len - buf->length;
+				if(step > m){
+					step = m;
+				}
+			}
+		}
+		buf->length += step;
+		m -= step;
 
 		if(!minBbLengthCheck(buf)){
 			if(!checkBbPreamble(buf)){
 				fail = true;
+				countBbLink(&link->preambleMisses, 1);
 			}
+		} else if(getBbPacketLength(buf) >= buf->bufferLength){
+			//this could never fit in the queue so don't wait for it
+			fail = true;
+			countBbLink(&link->oversizePackets, 1);
 		} else if(checkBbLength(buf)){
-			if(checkBbCrc(buf)){
+			updateBbLinear(buf);//the packet is complete so see if it wraps
+			if(checkBbRunningCrc(buf)){
 				result = true;//we have a valid packet
+				countBbLink(&link->packets, 1);
 				break;
 				//any remaining bytes should be checked after this packet has been consumed
 			} else {
 				fail = true;
+				countBbLink(&link->crcFailures, 1);
 			}
 		}
 
 		if(fail){
-			discardFromByteQ(q, buf->length);
+			//only discard up to the next preamble in the rejected bytes, if there is one
+			//the bytes from there on will be checked again as the start of a new packet
+			uint32_t k = findBbPreamble(buf, 1);
+			m += buf->length - k;
+			discardFromByteQ(q, k);
+			countBbLink(&link->bytesDiscarded, k);
 			buf->length = 0;
 			buf->start = q->front;
+			updateBbLinear(buf);
+			resetBbRunningCrc(buf);
+			fail = false;
 		}
 	}
+	if(!result){
+		//fold in the bytes from this call so that the crc is ready when the packet completes
+		updateBbRunningCrc(buf);
+	}
 	return result;
 }
 
@@ -144,22 +204,33 @@ static bool blueberryReceive(Bb* buf, ByteQ* q, uint32_t n){
  * This function will discard the queue contents if the packet fails the checks
  * This is implemented with function pointers. I tried to avoid them but it allows easy inclusion into the autogenerated code
  * @param buf - the buffer for this packet, also the state of the receive routine
+ * @param link - the health counters of the link
  * @return true if a valid packet was received
  */
-static bool blueberryReceivePacket(Bb* buf){
+static bool blueberryReceivePacket(Bb* buf, BbLinkStats* link){
 	bool result = false;
 
 	if(minBbLengthCheck(buf)){
 		if(checkBbPreamble(buf)){
 			if(checkBbLength(buf)){
 				result = true;
+			} else {
+				countBbLink(&link->truncatedPackets, 1);
 			}
+		} else {
+			countBbLink(&link->preambleMisses, 1);
 		}
+	} else {
+		countBbLink(&link->truncatedPackets, 1);
 	}
 
-	if(!result){
+	if(result){
+		countBbLink(&link->packets, 1);
+	} else {
+		countBbLink(&link->bytesDiscarded, buf->length);
 		buf->length = 0;
 	}
+	updateBbLinear(buf);
 
 	return result;
 
@@ -177,13 +248,14 @@ static void blueberryReceiveDone(Bb* bb, ByteQ* q){
 	bb->time = 0;
 	bb->length = 0;//this indicates that the state is reset
 	bb->start = 0;//don't really need to do this
-
+	bb->linearLength = 0;
 
 }
 /**
  * scans the input queue for packets, if found will respond with a response packet on the output queue.
  * this funcion will only process at most n bytes at a time
  * It uses the input buffer to store the recieving state between calls.
+ * This uses the default context, the same one as processBlueberryPacket() and the other functions that don't take a context
  *
  * @param inP - a packet used for receiving. This should be static
  * @param inQ - the queue that the bytes
@@ -191,25 +263,250 @@ static void blueberryReceiveDone(Bb* bb, ByteQ* q){
  * @param n - the maximum number of bytes to process in one run of this function - if 0 then assumes the whole packet is in the inQ
  */
 bool transceiveBrPacketN(Bb* inP, ByteQ* inQ, ByteQ* outQ, uint32_t n){
+	return transceiveBrPacketNCtx(getBbDefaultContext(), inP, inQ, outQ, n);
+}
+/**
+ * scans the input queue for packets and responds on the output queue, using the specified context
+ * @see transceiveBrPacketN()
+ * @param ctx - the context with the parsers and builders for this link
+ * @param inP - a packet used for receiving. This should be static
+ * @param inQ - the queue that the bytes
+ * @param outQ - the queue that a response packet will be sent on
+ * @param n - the maximum number of bytes to process in one run of this function
+ */
+bool transceiveBrPacketNCtx(BbContext* ctx, Bb* inP, ByteQ* inQ, ByteQ* outQ, uint32_t n){
 	bool result = false;
 	while(isByteQNotEmpty(inQ)){
-		if(blueberryReceive(inP, inQ, n)){
-			parseBbPacket(inP);
+		if(blueberryReceive(inP, inQ, n, &ctx->link)){
+			parseBbPacketCtx(ctx, inP);
 			blueberryReceiveDone(inP, inQ);
 			result = true;
+		} else if(getBytesUsed(inQ) <= inP->length){
+			//every byte in the queue is part of a packet that hasn't finished arriving
+			break;
 		}
 	}
 
 	if(result){
-		Bb op;
-		Bb* outP = &op;
+		sendBbResponse(ctx, outQ);
+	}
+	return result;
+}
+
+/**
+ * builds a response packet with the messages queued in the specified context, in place at the back of the output queue
+ * The packet is kept within the free space of the queue. Any messages that don't fit are left queued for the next response,
+ * and the response is counted as an overflow.
+ * Where the free space can be reached without wrapping, because it doesn't run past the end of the queue or the queue is mirrored,
+ * the packet is built in a buffer of just the free space. Otherwise it is built in the whole queue with its write limit set
+ * to the free space. Either way, bytes that haven't been sent yet are never written
+ * @param ctx - the context with the queued messages
+ * @param outQ - the queue that the response packet will be sent on
+ * @return true if a packet was added to the queue
+ */
+static bool sendBbResponse(BbContext* ctx, ByteQ* outQ){
+	uint32_t n = outQ->bufferSize - getBytesUsed(outQ) - 1;//a full queue always has one byte free, so it isn't mistaken for an empty one
+	uint32_t mirror = getBbRingMirror(outQ->buffer, outQ->bufferSize);
+	Bb op;
+	Bb* outP = &op;
+	if(outQ->back + n <= outQ->bufferSize + mirror){
+		outP->buffer = &outQ->buffer[outQ->back];
+		outP->bufferLength = n;
+		outP->mirrorLength = 0;
+		outP->writeLimit = 0;
+		outP->start = 0;
+	} else {
 		outP->buffer = outQ->buffer;
 		outP->bufferLength = outQ->bufferSize;
+		outP->mirrorLength = mirror;
+		outP->writeLimit = n;
 		outP->start = outQ->back;
-		outP->length = 0;
+	}
+	outP->length = 0;
+	updateBbLinear(outP);
 
-		makeBbPacketWithQueuedMessages(outP);
-		advanceByteQBack(outQ, outP->length);
+	makeBbPacketWithQueuedMessagesNCtx(ctx, outP, n);
+	if(isBbPacketRequestedCtx(ctx)){
+		//some messages didn't fit in the queue
+		countBbLink(&ctx->link.txOverflows, 1);
+	}
+	advanceByteQBack(outQ, outP->length);
+	return outP->length != 0;
+}
+
+/**
+ * gets the health counters of the link that the specified context receives from
+ * @param ctx - the context
+ * @return the counters. Take a snapshot of them with getBbLinkCounts()
+ */
+BbLinkStats* getBbLinkStats(BbContext* ctx){
+	return &ctx->link;
+}
+
+/**
+ * takes a snapshot of the health counters of a link
+ * This can be done from any thread while the link is receiving. Each counter is read once, so the snapshot is not
+ * exactly of one moment, but every count in it really happened
+ * @param s - the counters of the link, from getBbLinkStats() or a BbHandoff
+ * @param counts - set to the current counts
+ */
+void getBbLinkCounts(BbLinkStats* s, BbLinkCounts* counts){
+	counts->packets = (uint32_t)atomic_load_explicit(&s->packets, memory_order_relaxed);
+	counts->bytesDiscarded = (uint32_t)atomic_load_explicit(&s->bytesDiscarded, memory_order_relaxed);
+	counts->preambleMisses = (uint32_t)atomic_load_explicit(&s->preambleMisses, memory_order_relaxed);
+	counts->crcFailures = (uint32_t)atomic_load_explicit(&s->crcFailures, memory_order_relaxed);
+	counts->truncatedPackets = (uint32_t)atomic_load_explicit(&s->truncatedPackets, memory_order_relaxed);
+	counts->oversizePackets = (uint32_t)atomic_load_explicit(&s->oversizePackets, memory_order_relaxed);
+	counts->rxOverflows = (uint32_t)atomic_load_explicit(&s->rxOverflows, memory_order_relaxed);
+	counts->txOverflows = (uint32_t)atomic_load_explicit(&s->txOverflows, memory_order_relaxed);
+}
+
+/**
+ * counts bytes that were dropped because the receive queue was full. This is for the code that fills the queue
+ * This has its own counter, so it can be called from the receive interrupt while the main loop receives and responds.
+ * It must only be called from one thread or interrupt for each link
+ * @param s - the counters of the link
+ */
+void recordBbLinkOverflow(BbLinkStats* s){
+	countBbLink(&s->rxOverflows, 1);
+}
+
+/**
+ * adds to a health counter
+ * Each counter only has one writer (see BbLinkStats), so a plain load and store is enough and works on cores without atomic read-modify-write
+ * @param counter - the counter
+ * @param n - the amount to add
+ */
+static void countBbLink(atomic_uint_fast32_t* counter, uint32_t n){
+	atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+/**
+ * sets up a handoff of received packets from the specified queue
+ * This must be done before the producer or consumer start
+ * @param h - the handoff to set up
+ * @param q - the queue that the bytes arrive in
+ */
+void initBbHandoff(BbHandoff* h, ByteQ* q){
+	h->q = q;
+	h->rxQ = *q;
+	atomic_init(&h->head, 0);
+	atomic_init(&h->tail, 0);
+	atomic_init(&h->framed, 0);
+	memset(&h->link, 0, sizeof(h->link));
+	h->released = 0;
+	h->framedFront = q->front;
+	blueberryReceiveDone(&h->rx, NULL);
+}
+
+/**
+ * frames the packets that have arrived in the queue and hands them to the consumer. This is the producer side of the handoff
+ * This only looks at the bytes and never moves the front of the queue, so it can be called from the receive interrupt
+ * Bytes that aren't part of a packet are only skipped here. The consumer frees them from the queue
+ * If the handoff is full then framing stops until the consumer catches up
+ * @param h - the handoff
+ * @param n - the maximum number of bytes to process at one calling
+ * @return the number of packets handed off
+ */
+uint32_t frameBbHandoff(BbHandoff* h, uint32_t n){
+	uint32_t result = 0;
+	h->rxQ.back = h->q->back;
+	while(isByteQNotEmpty(&h->rxQ)){
+		uint32_t head = atomic_load_explicit(&h->head, memory_order_relaxed);
+		if(head - atomic_load_explicit(&h->tail, memory_order_acquire) >= BB_HANDOFF_NUM){
+			break;//wait for the consumer to take some
+		}
+		bool received = blueberryReceive(&h->rx, &h->rxQ, n, &h->link);
+		if(received){
+			BbPacketSpan* s = &h->spans[head & (BB_HANDOFF_NUM - 1)];
+			s->start = h->rx.start;
+			s->length = h->rx.length;
+			s->time = h->rx.time;
+			atomic_store_explicit(&h->head, head + 1, memory_order_release);
+			blueberryReceiveDone(&h->rx, &h->rxQ);
+			++result;
+		}
+		//everything before the front of our view has now been handed off or rejected
+		uint32_t framed = atomic_load_explicit(&h->framed, memory_order_relaxed);
+		framed += (h->rxQ.front + h->rxQ.bufferSize - h->framedFront) % h->rxQ.bufferSize;
+		h->framedFront = h->rxQ.front;
+		atomic_store_explicit(&h->framed, framed, memory_order_release);
+		if(!received && getBytesUsed(&h->rxQ) <= h->rx.length){
+			//every byte in the queue is part of a packet that hasn't finished arriving
+			break;
+		}
+	}
+	return result;
+}
+
+/**
+ * gets the oldest packet that has been handed off, without removing it. This is the consumer side of the handoff
+ * If there are no packets then any bytes that the producer rejected are freed from the queue
+ * @param h - the handoff
+ * @param bb - set to the packet, in place in the queue
+ * @return true if there was a packet
+ */
+bool takeBbHandoff(BbHandoff* h, Bb* bb){
+	ByteQ* q = h->q;
+	//read framed before head, so that any packet framed before framed was stored is seen
+	uint32_t framed = atomic_load_explicit(&h->framed, memory_order_acquire);
+	uint32_t head = atomic_load_explicit(&h->head, memory_order_acquire);
+	uint32_t tail = atomic_load_explicit(&h->tail, memory_order_relaxed);
+	if(head == tail){
+		//the producer may not have counted the last packet released yet, in which case framed is behind, so leave it until next time
+		uint32_t k = framed - h->released;
+		if((int32_t)k > 0){
+			discardFromByteQ(q, k);
+			h->released += k;
+		}
+		return false;
+	}
+	BbPacketSpan* s = &h->spans[tail & (BB_HANDOFF_NUM - 1)];
+	bb->buffer = q->buffer;
+	bb->bufferLength = q->bufferSize;
+	bb->mirrorLength = getBbRingMirror(q->buffer, q->bufferSize);
+	bb->writeLimit = 0;
+	bb->start = s->start;
+	bb->length = s->length;
+	bb->time = s->time;
+	updateBbLinear(bb);
+	return true;
+}
+
+/**
+ * frees the packet got with takeBbHandoff() from the queue, along with any rejected bytes before it
+ * @param h - the handoff
+ */
+void releaseBbHandoff(BbHandoff* h){
+	ByteQ* q = h->q;
+	uint32_t tail = atomic_load_explicit(&h->tail, memory_order_relaxed);
+	BbPacketSpan* s = &h->spans[tail & (BB_HANDOFF_NUM - 1)];
+	uint32_t end = (s->start + s->length) % q->bufferSize;
+	uint32_t k = (end + q->bufferSize - q->front) % q->bufferSize;
+	discardFromByteQ(q, k);
+	h->released += k;
+	atomic_store_explicit(&h->tail, tail + 1, memory_order_release);
+}
+
+/**
+ * parses all the packets that have been handed off and responds on the output queue
+ * This is the main loop half of transceiveBrPacketN(), with frameBbHandoff() as the other half
+ * @param ctx - the context with the parsers and builders for this link
+ * @param h - the handoff
+ * @param outQ - the queue that a response packet will be sent on
+ * @return true if any packets were parsed
+ */
+bool processBbHandoff(BbContext* ctx, BbHandoff* h, ByteQ* outQ){
+	bool result = false;
+	Bb b;
+	while(takeBbHandoff(h, &b)){
+		parseBbPacketCtx(ctx, &b);
+		releaseBbHandoff(h);
+		result = true;
+	}
+
+	if(result){
+		sendBbResponse(ctx, outQ);
 	}
 	return result;
 }
@@ -225,15 +522,28 @@ bool transceiveBrPacketN(Bb* inP, ByteQ* inQ, ByteQ* outQ, uint32_t n){
  * @param destPort - the port that this packet was sent to. This will be the blueberry port no doubt
  * @param data - the data payload of the packet
  * @param dataLength - the number of bytes of the packet
+ * This uses the default context, the same one as transceiveBrPacketN() and the other functions that don't take a context
  */
 bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t sourcePort, uint32_t destIp, uint16_t destPort, uint8_t* data, uint32_t dataLength){//EthernetPacket* ep,  Ipv4Packet* ip, UdpPacket* inUp){
+	return processBlueberryPacketCtx(getBbDefaultContext(), sourceMac, sourceIp, sourcePort, destIp, destPort, data, dataLength);
+}
+/**
+ * processes a UDP packet as a blueberry packet, using the specified context
+ * @see processBlueberryPacket()
+ * @param ctx - the context with the parsers and builders for this endpoint
+ */
+bool processBlueberryPacketCtx(BbContext* ctx, uint8_t sourceMac[6], uint32_t sourceIp, uint16_t sourcePort, uint32_t destIp, uint16_t destPort, uint8_t* data, uint32_t dataLength){
 
 //	EthernetPacket* nep = makeNewEthernetPacket(sourceMac, ETHERTYPE_IPV4);
 //	Ipv4Packet* ni4p = addIpv4Packet(nep, sourceIp, IP_PROT_UDP);
 //	UdpPacket* outUp = addUdpPacket(ni4p, BR_PORT, BR_PORT);
+	(void)destPort;//the listener is only registered on the blueberry port
 	uint32_t maxSize = 0;
-	uint8_t* outData = NULL;
-	outData = startUdpPacket(sourceMac, sourceIp, sourcePort, BB_UDP_PORT, &maxSize);
+	UdpResponse response;
+	response.mac = sourceMac;
+	response.ip = sourceIp;
+	response.port = sourcePort;
+	response.data = startUdpPacket(sourceMac, sourceIp, sourcePort, BB_UDP_PORT, &maxSize);
 	//this is where the BR packet data will be processed
 
 
@@ -247,29 +557,36 @@ bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t so
 
 	//if the recevied packet was not sent to a broadcast IP then record the time
 	if((destIp & 0xff) !=  0xff){
-		m_lastRxTime = getTimeInMicroSeconds();
+		ctx->lastRxTime = getTimeInMicroSeconds();
 	}
 
 	inP->buffer = data;
 	inP->length = dataLength;
 	inP->bufferLength = dataLength;
+	inP->mirrorLength = 0;
+	inP->writeLimit = 0;
 	inP->start = 0;
 	inP->time = getLocalTimeMillis();
+	updateBbLinear(inP);
 
-	outP->buffer = outData;
+	outP->buffer = response.data;
 	outP->length = 0;
 	outP->bufferLength = maxSize;
+	outP->mirrorLength = 0;
+	outP->writeLimit = 0;
 	outP->start = 0;
 	outP->time = getLocalTimeMillis();
+	updateBbLinear(outP);
 
 	bool result = false;
-	if(blueberryReceivePacket(inP)){
-		parseBbPacket(inP);
+	if(blueberryReceivePacket(inP, &ctx->link)){
+		parseBbPacketCtx(ctx, inP);
 		blueberryReceiveDone(inP, NULL);
 		result = true;
 	}
 	if(result){
-		makeBbPacketWithQueuedMessages(outP);
+		//the response may need more than one UDP packet
+		makeBbPacketsWithQueuedMessagesCtx(ctx, outP, nextUdpResponsePacket, &response);
 
 	}
 	if(outP->length > 0){
@@ -278,19 +595,50 @@ bool processBlueberryPacket(uint8_t sourceMac[6], uint32_t sourceIp, uint16_t so
 //		finishIpv4Packet(ni4p, nlen);
 //		nlen += sizeof(Ipv4Packet);
 //		finishAndSendEthernetPacket(nep, nlen);
-		completeUdpPacket(outData, outP->length, false);
+		completeUdpPacket(response.data, outP->length, false);
 
 
 	}
 	return result;
 
 }
+/**
+ * sends a full packet of a UDP response and starts a new UDP packet for the rest of the response
+ * This matches the function signature of @see BbNextBuffer
+ * @param bb - the buffer containing the full packet
+ * @param context - the UdpResponse
+ * @return true if a new packet was started
+ */
+static bool nextUdpResponsePacket(Bb* bb, void* context){
+	UdpResponse* r = (UdpResponse*)context;
+	completeUdpPacket(r->data, bb->length, false);
+
+	uint32_t maxSize = 0;
+	r->data = startUdpPacket(r->mac, r->ip, r->port, BB_UDP_PORT, &maxSize);
+	bb->buffer = r->data;
+	bb->bufferLength = maxSize;
+	bb->mirrorLength = 0;
+	bb->writeLimit = 0;
+	bb->start = 0;
+	bb->length = 0;
+	updateBbLinear(bb);
+	return r->data != NULL;
+}
 /**
  * Checks if we've recevied a packet within the specified time. Specifically checks to see if we HAVEN'T
  * @param microseconds - the specified timeout
  * @return true if time since last received packet is greater than the specified time
  */
 bool isLastPacketTimeNotWithin(uint32_t microseconds){
-	return slowTimer(&m_lastRxTime, microseconds);
+	return isLastPacketTimeNotWithinCtx(getBbDefaultContext(), microseconds);
+}
+/**
+ * Checks if the specified context hasn't received a packet within the specified time
+ * @param ctx - the context of the endpoint
+ * @param microseconds - the specified timeout
+ * @return true if time since last received packet is greater than the specified time
+ */
+bool isLastPacketTimeNotWithinCtx(BbContext* ctx, uint32_t microseconds){
+	return slowTimer(&ctx->lastRxTime, microseconds);
 }
 
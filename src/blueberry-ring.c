@@ -0,0 +1,184 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE//for memfd_create(). This must come before any system header
+#endif
+#include <blueberry-ring.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static BbRing* m_rings[BB_RING_NUM];//not locked, see blueberry-ring.h
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static bool openMirroredRing(BbRing* r, uint32_t size);
+
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+/**
+ * allocates a ring buffer, mirrored if the platform supports it
+ * A mirrored buffer is rounded up to a whole number of pages. The page size is a power of two,
+ * so a buffer that was asked for as a power of two of at least a page stays one, and can still be masked
+ * @param r - the ring to allocate. This must stay allocated until closeBbRing() is called
+ * @param size - the size of the buffer in bytes
+ * @return true if the buffer was allocated
+ */
+bool openBbRing(BbRing* r, uint32_t size){
+	r->buffer = NULL;
+	r->size = 0;
+	r->mirrored = false;
+	if(size == 0){
+		return false;
+	}
+	uint32_t k = 0;
+	while(k < BB_RING_NUM && m_rings[k] != NULL){
+		++k;
+	}
+	if(k >= BB_RING_NUM){
+		return false;
+	}
+	if(!openMirroredRing(r, size)){
+		//fall back to an ordinary buffer, which the accessors will wrap
+		r->buffer = (uint8_t*)malloc(size);
+		if(r->buffer == NULL){
+			return false;
+		}
+		r->size = size;
+	}
+	m_rings[k] = r;
+	return true;
+}
+
+/**
+ * frees a ring buffer allocated by openBbRing()
+ * @param r - the ring
+ */
+void closeBbRing(BbRing* r){
+	for(uint32_t k = 0; k < BB_RING_NUM; ++k){
+		if(m_rings[k] == r){
+			m_rings[k] = NULL;
+		}
+	}
+	if(r->buffer == NULL){
+		return;
+	}
+#if defined(__linux__)
+	if(r->mirrored){
+		munmap(r->buffer, (size_t)r->size * 2);
+	} else {
+		free(r->buffer);
+	}
+#else
+	free(r->buffer);
+#endif
+	r->buffer = NULL;
+	r->size = 0;
+	r->mirrored = false;
+}
+
+/**
+ * finds how many bytes after the end of the specified buffer mirror its start
+ * This is how the receiver learns that a ByteQ was allocated by openBbRing()
+ * A queue that uses less than the whole ring would wrap before the mirror, so it is treated as unmirrored
+ * @param buffer - the start of the buffer
+ * @param size - the size of the buffer as the queue uses it
+ * @return the size of the buffer if it is mirrored and the queue uses all of it, otherwise 0
+ */
+uint32_t getBbRingMirror(const uint8_t* buffer, uint32_t size){
+	for(uint32_t k = 0; k < BB_RING_NUM; ++k){
+		BbRing* r = m_rings[k];
+		if(r != NULL && r->buffer == buffer && r->mirrored && r->size == size){
+			return r->size;
+		}
+	}
+	return 0;
+}
+
+/**
+ * maps a memfd twice, back to back, so the second mapping mirrors the first
+ * @param r - the ring to fill in
+ * @param size - the size asked for, which is rounded up to whole pages
+ * @return true if the mirror was mapped, false if the platform can't do it
+ */
+static bool openMirroredRing(BbRing* r, uint32_t size){
+#if defined(__linux__)
+	long page = sysconf(_SC_PAGESIZE);
+	if(page <= 0){
+		return false;
+	}
+	size_t n = ((size_t)size + (size_t)page - 1) / (size_t)page * (size_t)page;
+	if(n * 2 > UINT32_MAX){
+		return false;
+	}
+	int fd = memfd_create("blueberry-ring", MFD_CLOEXEC);
+	if(fd < 0){
+		return false;
+	}
+	if(ftruncate(fd, (off_t)n) != 0){
+		close(fd);
+		return false;
+	}
+	//reserve room for both copies, then map the file over each half
+	uint8_t* p = (uint8_t*)mmap(NULL, n * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if(p == MAP_FAILED){
+		close(fd);
+		return false;
+	}
+	void* a = mmap(p, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	void* b = mmap(p + n, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+	close(fd);//the mappings keep the memory alive
+	if(a == MAP_FAILED || b == MAP_FAILED){
+		munmap(p, n * 2);
+		return false;
+	}
+	r->buffer = p;
+	r->size = (uint32_t)n;
+	r->mirrored = true;
+	return true;
+#else
+	(void)r;
+	(void)size;
+	return false;
+#endif
+}
@@ -0,0 +1,187 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <blueberry-stats.h>
+#include <blueberry-message.h>
+#include <stddef.h>
+#include <string.h>
+
+#if BB_STATS
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+//the layout of the message made by buildBbStatsMessage()
+#define STATS_UNKNOWN_KEYS_INDEX (8)
+#define STATS_DROPPED_KEYS_INDEX (12)
+#define STATS_ENTRIES_INDEX (16)//the placeholder of the sequence of entries
+#define STATS_FIXED_LENGTH (20)
+#define STATS_MAX_ORDINAL (3)
+//the layout of each entry of the sequence
+#define STATS_ENTRY_KEY_INDEX (0)
+#define STATS_ENTRY_COUNT_INDEX (4)//parse then build
+#define STATS_ENTRY_BYTES_INDEX (12)//parse then build
+#define STATS_ENTRY_HISTOGRAM_INDEX (20)//the parse histogram then the build histogram
+#define STATS_ENTRY_LENGTH (STATS_ENTRY_HISTOGRAM_INDEX + 2*4*BB_STATS_BIN_NUM)
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static BbStatsEntry* findEntry(BbStats* s, uint32_t key, bool add);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+/**
+ * forgets all the counts, and starts the cycle counter if needed
+ * @param s - the counts
+ */
+void resetBbStats(BbStats* s){
+	memset(s, 0, sizeof(BbStats));
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+	*(volatile uint32_t*)0xE000EDFC |= (1ul << 24);//CoreDebug->DEMCR, enable the trace unit
+	*(volatile uint32_t*)0xE0001000 |= 1;//DWT->CTRL, enable the cycle counter
+#endif
+}
+
+/**
+ * counts one parse or build of a message
+ * @param s - the counts
+ * @param kind - BB_STATS_PARSE or BB_STATS_BUILD
+ * @param key - the module/message key of the message
+ * @param bytes - the length of the message
+ * @param cycles - how long it took, as measured with getBbStatsCycles()
+ */
+void recordBbStats(BbStats* s, uint32_t kind, uint32_t key, uint32_t bytes, uint32_t cycles){
+	BbStatsEntry* e = findEntry(s, key, true);
+	if(e == NULL){
+		++s->droppedKeys;
+		return;
+	}
+	uint32_t bin = 0;
+	while(cycles >= 4 && bin < BB_STATS_BIN_NUM - 1){
+		cycles >>= 2;
+		++bin;
+	}
+	++e->count[kind];
+	e->bytes[kind] += bytes;
+	++e->histogram[kind][bin];
+}
+
+/**
+ * gets the counts for the specified key
+ * @param s - the counts
+ * @param key - the module/message key
+ * @return the counts, or NULL if the key hasn't been seen
+ */
+const BbStatsEntry* getBbStatsEntry(const BbStats* s, uint32_t key){
+	return findEntry((BbStats*)s, key, false);
+}
+
+/**
+ * builds a message containing the counts, so they can be read remotely
+ * The message has the number of unknown and dropped keys followed by a sequence of entries, one per key.
+ * Each entry has the key, the parse and build counts, the parse and build byte counts and then the parse and build histograms, all as uint32.
+ * Only as many entries as fit in the rest of the buffer are included
+ * This can be called from a builder, with the key it was registered with
+ * @param bb - the buffer to build the message in
+ * @param msg - the index of the start of the message
+ * @param key - the module/message key to give the message
+ * @param s - the counts
+ */
+void buildBbStatsMessage(Bb* bb, BbBlock msg, uint32_t key, const BbStats* s){
+	uint32_t n = 0;
+	for(uint32_t i = 0; i < BB_STATS_KEY_NUM; ++i){
+		if(s->entries[i].used){
+			++n;
+		}
+	}
+	uint32_t room = bb->bufferLength - bb->length;
+	if(room < STATS_FIXED_LENGTH + 4){
+		room = STATS_FIXED_LENGTH + 4;//let it overflow, so the packet builder knows it didn't fit
+	}
+	room = (room - STATS_FIXED_LENGTH - 4) / STATS_ENTRY_LENGTH;
+	n = n > room ? room : n;
+
+	bb->length += STATS_FIXED_LENGTH;
+	setBbUint32(bb, msg, 0, key);
+	setBbUint16(bb, msg, 4, STATS_FIXED_LENGTH/4);
+	setBbUint8(bb, msg, 6, STATS_MAX_ORDINAL);
+	setBbUint32(bb, msg, STATS_UNKNOWN_KEYS_INDEX, s->unknownKeys);
+	setBbUint32(bb, msg, STATS_DROPPED_KEYS_INDEX, s->droppedKeys);
+	initBbSequence(bb, msg, STATS_ENTRIES_INDEX, STATS_ENTRY_LENGTH, n);
+
+	uint32_t j = 0;
+	for(uint32_t i = 0; i < BB_STATS_KEY_NUM && j < n; ++i){
+		const BbStatsEntry* e = &s->entries[i];
+		if(!e->used){
+			continue;
+		}
+		BbBlock b = getBbSequenceElementIndex(bb, msg, STATS_ENTRIES_INDEX, j++) + msg;
+		setBbUint32(bb, b, STATS_ENTRY_KEY_INDEX, e->key);
+		for(uint32_t k = 0; k < 2; ++k){
+			setBbUint32(bb, b, STATS_ENTRY_COUNT_INDEX + 4*k, e->count[k]);
+			setBbUint32(bb, b, STATS_ENTRY_BYTES_INDEX + 4*k, e->bytes[k]);
+			for(uint32_t h = 0; h < BB_STATS_BIN_NUM; ++h){
+				setBbUint32(bb, b, STATS_ENTRY_HISTOGRAM_INDEX + 4*(k*BB_STATS_BIN_NUM + h), e->histogram[k][h]);
+			}
+		}
+	}
+}
+
+/**
+ * finds the entry for the specified key in the hash table of entries
+ * @param s - the counts
+ * @param key - the module/message key
+ * @param add - true to add an entry if there isn't one
+ * @return the entry, or NULL if there isn't one and it couldn't or shouldn't be added
+ */
+static BbStatsEntry* findEntry(BbStats* s, uint32_t key, bool add){
+	uint32_t h = (key ^ (key >> 16)) * 0x45d9f3bu;
+	h ^= h >> 16;
+	for(uint32_t i = 0; i < BB_STATS_KEY_NUM; ++i){
+		BbStatsEntry* e = &s->entries[(h + i) & (BB_STATS_KEY_NUM - 1)];
+		if(!e->used){
+			if(!add){
+				return NULL;
+			}
+			e->used = true;
+			e->key = key;
+			return e;
+		} else if(e->key == key){
+			return e;
+		}
+	}
+	return NULL;
+}
+
+#endif //BB_STATS
@@ -25,8 +25,10 @@ THE SOFTWARE.
 //Includes
 //*******************************************************************************************
 #include <blueberry-transcoder.h>
+#include <blueberry-crc.h>
 
 #include <crc1021.h>
+#include <string.h>
 //*******************************************************************************************
 //Defines
 //*******************************************************************************************
@@ -42,6 +44,8 @@ THE SOFTWARE.
 //*******************************************************************************************
 //Function Prototypes
 //*******************************************************************************************
+static uint32_t bbContiguous(Bb* buf, uint32_t j, uint8_t** p);
+static bool isBbWritable(Bb* buf, uint32_t j);
 
 //*******************************************************************************************
 //Code
@@ -54,7 +58,7 @@ THE SOFTWARE.
  *  @param i the index offset in bytes
  *  @return the value
  */
-uint8_t getBbUint8(Bb* buf, BbBlock block, uint16_t i){
+uint8_t getBbUint8(Bb* buf, BbBlock block, BbBlock i){
 	return buf->buffer[bbWrap(buf, block + i)];
 }
 
@@ -65,7 +69,10 @@ uint8_t getBbUint8(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbUint8(Bb* buf, BbBlock block, uint16_t i, uint8_t v){
+void setBbUint8(Bb* buf, BbBlock block, BbBlock i, uint8_t v){
+	if(!isBbWritable(buf, (uint32_t)block + i)){
+		return;//the packet has outgrown the buffer, and this would overwrite the start of it or bytes that aren't ours
+	}
 	buf->buffer[bbWrap(buf, block + i)] = v;
 }
 
@@ -76,7 +83,7 @@ void setBbUint8(Bb* buf, BbBlock block, uint16_t i, uint8_t v){
  *  @param i the index offset in bytes
  *  @return the value
  */
-int8_t getBbInt8(Bb* buf, BbBlock block, uint16_t i){
+int8_t getBbInt8(Bb* buf, BbBlock block, BbBlock i){
 	return (int8_t)getBbUint8(buf, block, i);
 }
 
@@ -87,7 +94,7 @@ int8_t getBbInt8(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbInt8(Bb* buf, BbBlock block, uint16_t i, int8_t v){
+void setBbInt8(Bb* buf, BbBlock block, BbBlock i, int8_t v){
 	setBbUint8(buf, block, i, (uint8_t)v);
 }
 
@@ -99,12 +106,8 @@ void setBbInt8(Bb* buf, BbBlock block, uint16_t i, int8_t v){
  *  @param i the index offset in bytes
  *  @return the value
  */
-uint16_t getBbUint16(Bb* buf, BbBlock block, uint16_t i){
-	uint16_t result;
-	uint8_t* bs = (uint8_t*)&result;
-	bs[0] = getBbUint8(buf, block, i);
-	bs[1] = getBbUint8(buf, block, i+1);
-	return result;
+uint16_t getBbUint16(Bb* buf, BbBlock block, BbBlock i){
+	return (uint16_t)(getBbUint8(buf, block, i) | (getBbUint8(buf, block, i+1) << 8));
 }
 
 /**
@@ -114,10 +117,9 @@ uint16_t getBbUint16(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbUint16(Bb* buf, BbBlock block, uint16_t i, uint16_t v){
-	uint8_t* bs = (uint8_t*)&v;
-	setBbUint8(buf, block, i,   bs[0]);
-	setBbUint8(buf, block, i+1, bs[1]);
+void setBbUint16(Bb* buf, BbBlock block, BbBlock i, uint16_t v){
+	setBbUint8(buf, block, i,   (uint8_t)v);
+	setBbUint8(buf, block, i+1, (uint8_t)(v >> 8));
 }
 
 /**
@@ -127,7 +129,7 @@ void setBbUint16(Bb* buf, BbBlock block, uint16_t i, uint16_t v){
  *  @param i the index offset in bytes
  *  @return the value
  */
-int16_t getBbInt16(Bb* buf, BbBlock block, uint16_t i){
+int16_t getBbInt16(Bb* buf, BbBlock block, BbBlock i){
 	return (int16_t)getBbUint16(buf, block, i);
 }
 
@@ -138,7 +140,7 @@ int16_t getBbInt16(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbInt16(Bb* buf, BbBlock block, uint16_t i, int16_t v){
+void setBbInt16(Bb* buf, BbBlock block, BbBlock i, int16_t v){
 	setBbUint16(buf, block, i, (uint16_t)v);
 }
 
@@ -149,14 +151,11 @@ void setBbInt16(Bb* buf, BbBlock block, uint16_t i, int16_t v){
  *  @param i the index offset in bytes
  *  @return the value
  */
-uint32_t getBbUint32(Bb* buf, BbBlock block, uint16_t i){
-	uint32_t result;
-	uint8_t* bs = (uint8_t*)&result;
-	bs[0] = getBbUint8(buf, block, i);
-	bs[1] = getBbUint8(buf, block, i+1);
-	bs[2] = getBbUint8(buf, block, i+2);
-	bs[3] = getBbUint8(buf, block, i+3);
-	return result;
+uint32_t getBbUint32(Bb* buf, BbBlock block, BbBlock i){
+	return (uint32_t)getBbUint8(buf, block, i)
+		| ((uint32_t)getBbUint8(buf, block, i+1) << 8)
+		| ((uint32_t)getBbUint8(buf, block, i+2) << 16)
+		| ((uint32_t)getBbUint8(buf, block, i+3) << 24);
 }
 
 /**
@@ -166,12 +165,11 @@ uint32_t getBbUint32(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbUint32(Bb* buf, BbBlock block, uint16_t i, uint32_t v){
-	uint8_t* bs = (uint8_t*)&v;
-	setBbUint8(buf, block, i,   bs[0]);
-	setBbUint8(buf, block, i+1, bs[1]);
-	setBbUint8(buf, block, i+2, bs[2]);
-	setBbUint8(buf, block, i+3, bs[3]);
+void setBbUint32(Bb* buf, BbBlock block, BbBlock i, uint32_t v){
+	setBbUint8(buf, block, i,   (uint8_t)v);
+	setBbUint8(buf, block, i+1, (uint8_t)(v >> 8));
+	setBbUint8(buf, block, i+2, (uint8_t)(v >> 16));
+	setBbUint8(buf, block, i+3, (uint8_t)(v >> 24));
 
 }
 
@@ -182,7 +180,7 @@ void setBbUint32(Bb* buf, BbBlock block, uint16_t i, uint32_t v){
  *  @param i the index offset in bytes
  *  @return the value
  */
-int32_t getBbInt32(Bb* buf, BbBlock p, uint16_t i){
+int32_t getBbInt32(Bb* buf, BbBlock p, BbBlock i){
 	return (int32_t)getBbUint32(buf, p, i);
 
 
@@ -195,7 +193,7 @@ int32_t getBbInt32(Bb* buf, BbBlock p, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbInt32(Bb* buf, BbBlock block, uint16_t i, int32_t v){
+void setBbInt32(Bb* buf, BbBlock block, BbBlock i, int32_t v){
 	setBbUint32(buf, block, i, (uint32_t)v);
 
 }
@@ -208,7 +206,7 @@ void setBbInt32(Bb* buf, BbBlock block, uint16_t i, int32_t v){
  *  @return the value
  *
  */
-float getBbFloat32(Bb* buf, BbBlock block, uint16_t i){
+float getBbFloat32(Bb* buf, BbBlock block, BbBlock i){
 	uint32_t ip = getBbUint32(buf, block, i);
 	float* fp = (float*)(&ip);
 	return *fp;
@@ -221,7 +219,7 @@ float getBbFloat32(Bb* buf, BbBlock block, uint16_t i){
  *  @param i the index offset in bytes
  *  @param v the value to write
  */
-void setBbFloat32(Bb* buf, BbBlock block, uint16_t i, float v){
+void setBbFloat32(Bb* buf, BbBlock block, BbBlock i, float v){
 	float* fp = &v;
 	uint32_t* ip = (uint32_t*)fp;
 	setBbUint32(buf, block, i, *ip);
@@ -235,7 +233,7 @@ void setBbFloat32(Bb* buf, BbBlock block, uint16_t i, float v){
  *  @param bitMask the mask for the bit in question: (1<<bitNum)
  *  @return the value
  */
-bool getBbBool(Bb* buf, BbBlock block, uint16_t i, uint32_t bitMask){
+bool getBbBool(Bb* buf, BbBlock block, BbBlock i, uint32_t bitMask){
 	uint8_t bf = getBbUint8(buf, block, i);
 	return (bf & bitMask) != 0;
 }
@@ -248,7 +246,10 @@ bool getBbBool(Bb* buf, BbBlock block, uint16_t i, uint32_t bitMask){
  *  @param bitMask the mask for the bit in question: (1<<bitNum)
  *  @param v the value to write
  */
-void setBbBool(Bb* buf, BbBlock block, uint16_t i, uint32_t bitMask, bool v){
+void setBbBool(Bb* buf, BbBlock block, BbBlock i, uint32_t bitMask, bool v){
+	if(!isBbWritable(buf, (uint32_t)block + i)){
+		return;//the packet has outgrown the buffer, and this would overwrite the start of it or bytes that aren't ours
+	}
 	uint8_t* b = &(buf->buffer[bbWrap(buf, block + i)]);
 	uint8_t m = bitMask;
 	if(v){
@@ -258,6 +259,158 @@ void setBbBool(Bb* buf, BbBlock block, uint16_t i, uint32_t bitMask, bool v){
 	}
 }
 
+/**
+ * computes how much of the packet can be accessed without wrapping, and if the buffer can be wrapped with a mask
+ * This is the number of bytes from the packet start to either the end of the packet or the end of the buffer, whichever comes first
+ * The fast accessors will only skip the wrap for fields that lie entirely within this range
+ * If the buffer is mirrored then the whole packet is linear, wherever it starts
+ * If the buffer length is a power of two then wrapMask is set, and bbWrap() masks instead of taking the modulo
+ * Any packet that was verified no longer is
+ * This should be called once the start, length and buffer of the packet are known
+ * @param buf the buffer to check
+ */
+void updateBbLinear(Bb* buf){
+	uint32_t b = buf->bufferLength;
+	buf->wrapMask = (b != 0 && (b & (b - 1)) == 0) ? b - 1 : 0;
+	buf->verified = false;//the packet has changed, so it has to be validated again
+
+	uint32_t n = 0;
+	uint32_t end = buf->bufferLength + buf->mirrorLength;//a mirrored buffer can be read straight past its end
+	if(buf->start < end){
+		n = end - buf->start;
+	}
+	if(n > buf->length){
+		n = buf->length;
+	}
+	if(n > buf->bufferLength){
+		n = buf->bufferLength;//any further would alias the start of the packet
+	}
+	if(buf->writeLimit != 0 && n > buf->writeLimit){
+		n = buf->writeLimit;//so that the fast setters fall back to the checked ones past the limit
+	}
+	buf->linearLength = n;
+}
+
+/**
+ * tests if the buffer can be wrapped with a mask, so the masked accessors can be used
+ * @param buf the buffer to check. updateBbLinear() must have been called on it
+ * @return true if the buffer length is a power of two
+ */
+bool isBbMasked(Bb* buf){
+	return buf->wrapMask != 0;
+}
+
+/**
+ * tests if the packet has been validated, so the verified accessors can be used
+ * @param buf the buffer to check
+ * @return true if validateBbPacket() has passed the packet since it last changed
+ */
+bool isBbVerified(Bb* buf){
+	return buf->verified;
+}
+
+/**
+ * copies the specified number of bytes from the specified block to memory
+ * This uses at most two memcpy() calls, split where the buffer wraps
+ *  @param buf the buffer to read
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param dest the memory to copy to
+ *  @param n the number of bytes to copy
+ */
+void getBbBytes(Bb* buf, BbBlock block, BbBlock i, uint8_t* dest, uint32_t n){
+	uint32_t j = (uint32_t)block + i;
+	while(n > 0){
+		uint8_t* p;
+		uint32_t m = bbContiguous(buf, j, &p);
+		if(m == 0){
+			//past the end of the packet, so do what the byte accessor would
+			*dest = getBbUint8(buf, 0, j);
+			m = 1;
+		} else {
+			if(m > n){
+				m = n;
+			}
+			memcpy(dest, p, m);
+		}
+		dest += m;
+		j += m;
+		n -= m;
+	}
+}
+
+/**
+ * copies the specified number of bytes from memory to the specified block
+ * This uses at most two memcpy() calls, split where the buffer wraps. Bytes past the write limit are dropped
+ *  @param buf the buffer to write
+ *  @param block the block offset in bytes
+ *  @param i the index offset in bytes
+ *  @param src the memory to copy from
+ *  @param n the number of bytes to copy
+ */
+void setBbBytes(Bb* buf, BbBlock block, BbBlock i, const uint8_t* src, uint32_t n){
+	uint32_t j = (uint32_t)block + i;
+	while(n > 0){
+		uint8_t* p;
+		uint32_t m = bbContiguous(buf, j, &p);
+		if(m == 0){
+			//past the end of the packet, so do what the byte accessor would
+			setBbUint8(buf, 0, j, *src);
+			m = 1;
+		} else {
+			if(m > n){
+				m = n;
+			}
+			if(buf->writeLimit != 0 && j + m > buf->writeLimit){
+				if(j >= buf->writeLimit){
+					return;
+				}
+				m = buf->writeLimit - j;
+			}
+			memcpy(p, src, m);
+		}
+		src += m;
+		j += m;
+		n -= m;
+	}
+}
+
+/**
+ * finds how many bytes of the packet can be accessed directly from the specified index
+ * @param buf the buffer
+ * @param j the index into the packet
+ * @param p a pointer to the location of that index in the buffer
+ * @return the number of bytes to either the end of the packet or the end of the buffer, zero if the index is not in the packet
+ */
+static uint32_t bbContiguous(Bb* buf, uint32_t j, uint8_t** p){
+	if(j >= buf->length || j >= buf->bufferLength){
+		return 0;
+	}
+	uint32_t k = bbWrap(buf, j);
+	uint32_t m = buf->bufferLength + buf->mirrorLength - k;
+	if(m > buf->length - j){
+		m = buf->length - j;
+	}
+	if(m > buf->bufferLength - j){
+		m = buf->bufferLength - j;//any further would alias the start of the packet
+	}
+	*p = &buf->buffer[k];
+	return m;
+}
+
+/**
+ * tests if a byte of the packet can be written, because it is within both the buffer and the write limit
+ * @param buf the buffer
+ * @param j the index into the packet
+ * @return true if the byte can be written
+ */
+static bool isBbWritable(Bb* buf, uint32_t j){
+	if(j >= buf->bufferLength){
+		return false;
+	}
+	return buf->writeLimit == 0 || j < buf->writeLimit;
+}
+
 /**
  * Checks for overflows and
  * converts a linear index to a circular one
@@ -266,13 +419,17 @@ void setBbBool(Bb* buf, BbBlock block, uint16_t i, uint32_t bitMask, bool v){
  */
 uint32_t bbWrap(Bb* buf, int i){
 	uint32_t j;
-	if(i >= buf->length){
+	if((uint32_t)i >= buf->length){
 		j = 0;//this should be safe but will obviously return the wrong value
 		asm("nop");
 	} else {
 		j = i + buf->start;
-		uint32_t n = buf->bufferLength;
-		j %= n;
+		if(buf->wrapMask != 0){
+			j &= buf->wrapMask;//the buffer is a power of two so skip the divide
+		} else {
+			uint32_t n = buf->bufferLength;
+			j %= n;
+		}
 	}
 	return j;
 }
@@ -286,12 +443,7 @@ uint16_t computeCrc(Bb* buf, BbBlock block, BbBlock end){
 
 	uint16_t crc;
 	resetCrc1021P(&crc);
-	for(uint16_t i = block; i < end; i += 4){
-		uint32_t w = getBbUint32(buf, i, 0);
-
-		crc1021P32(&crc, w);
-//		getCrc1021P(&crc);
-	}
+	crc = foldBbCrc(buf, crc, block, end);
 
 	//do from the start to either the buffer end or the block end
 	getCrc1021P(&crc);
@@ -299,7 +451,62 @@ uint16_t computeCrc(Bb* buf, BbBlock block, BbBlock end){
 }
 
 /**
- * tests if the specified index is not equal to the invalid value 0xffffffff
+ * folds the specified blocks of the buffer into a running crc, one word at a time
+ * Whole words that lie in the packet are read straight from the buffer, split at most once where the ring wraps.
+ * Any word that straddles the wrap or the end of the packet is gathered a byte at a time. Either way each word is read little endian.
+ * @param buf the buffer
+ * @param crc the running crc
+ * @param block the first element
+ * @param one past the last element
+ * @return the updated crc
+ */
+uint16_t foldBbCrc(Bb* buf, uint16_t crc, BbBlock block, BbBlock end){
+	uint32_t n = buf->length;
+	uint32_t wrap = 0;//the packet index past the end of the buffer and its mirror, which is mirrorLength into the buffer
+	uint32_t end1 = 0;//the end of the part of the packet before the wrap
+	uint32_t end2 = 0;//the end of the part of the packet after the wrap
+	uint32_t limit = buf->bufferLength + buf->mirrorLength;//a mirrored buffer only wraps after the mirror
+	if(buf->start < limit){
+		wrap = limit - buf->start;
+		end1 = wrap < n ? wrap : n;
+		end2 = wrap + buf->bufferLength < n ? wrap + buf->bufferLength : n;
+	}
+
+	uint32_t i = block;
+	while(i < end){
+		const uint8_t* p = NULL;
+		uint32_t available = 0;
+		if(i < end1){
+			p = &buf->buffer[buf->start + i];
+			available = end1 - i;
+		} else if(i >= wrap && i < end2){
+			p = &buf->buffer[i - wrap + buf->mirrorLength];
+			available = end2 - i;
+		}
+		uint32_t wordNum = available / 4;
+		uint32_t remaining = (end - i + 3) / 4;
+		if(wordNum > remaining){
+			wordNum = remaining;
+		}
+		if(wordNum > 0){
+			crc = updateBbCrc(crc, p, wordNum);
+			i += wordNum * 4;
+		} else {
+			//this word straddles the wrap or the packet end, so gather its bytes and fold them in the same way
+			uint8_t w[4];
+			for(uint32_t k = 0; k < 4; ++k){
+				w[k] = getBbUint8(buf, (BbBlock)(i + k), 0);
+			}
+			crc = updateBbCrc(crc, w, 1);
+			i += 4;
+		}
+	}
+
+	return crc;
+}
+
+/**
+ * tests if the specified index is equal to the invalid value BB_INVALID_BLOCK
  */
 bool isBbBlockInvalid(BbBlock b){
 	return b == BB_INVALID_BLOCK;
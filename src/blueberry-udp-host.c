@@ -0,0 +1,378 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE//for recvmmsg() and sendmmsg(). This must come before any system header
+#endif
+#include <blueberry-udp-host.h>
+
+#if defined(__linux__)
+#include <ethernet.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define TX_NUM (BB_UDP_HOST_BATCH)//the number of response buffers
+
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+typedef struct {
+	int fd;
+	uint16_t port;
+	UdpPacketProcessor processor;
+} Listener;
+
+typedef enum {
+	TX_FREE = 0,
+	TX_STARTED,//handed out by startUdpPacket()
+	TX_READY,//completed by completeUdpPacket() and waiting to be sent
+} TxState;
+
+typedef struct {
+	TxState state;
+	int fd;//the socket to send from
+	struct sockaddr_in to;
+	uint32_t length;
+} Tx;
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static Listener m_listeners[BB_UDP_HOST_LISTENER_NUM];
+static uint32_t m_listenerNum = 0;
+static uint32_t m_truncatedNum = 0;//the number of datagrams received that were bigger than BB_UDP_HOST_MTU
+
+//receive buffers, filled by one recvmmsg() call
+static uint8_t m_rxData[BB_UDP_HOST_BATCH][BB_UDP_HOST_MTU];
+static struct sockaddr_in m_rxFrom[BB_UDP_HOST_BATCH];
+static uint8_t m_rxControl[BB_UDP_HOST_BATCH][CMSG_SPACE(sizeof(struct in_pktinfo))];
+static struct iovec m_rxIov[BB_UDP_HOST_BATCH];
+static struct mmsghdr m_rxMsgs[BB_UDP_HOST_BATCH];
+
+//response buffers, sent by one sendmmsg() call per socket
+static uint8_t m_txData[TX_NUM][BB_UDP_HOST_MTU];
+static Tx m_tx[TX_NUM];
+static struct iovec m_txIov[TX_NUM];
+static struct mmsghdr m_txMsgs[TX_NUM];
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static Listener* findListener(uint16_t port);
+static uint32_t receiveBatch(Listener* l);
+static uint32_t getDestIp(struct msghdr* h);
+static void freeStartedBuffers(void);
+
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+/**
+ * opens a socket on the specified port and calls the processor for every datagram received on it
+ * This matches the function of the same name provided by the firmware network stack
+ * Will fail silently if the socket can't be opened or there are too many listeners
+ * @param port - the port to listen on
+ * @param p - the function to process each datagram
+ * @param b - not used on the host
+ */
+void registerUdpListener(uint16_t port, UdpPacketProcessor p, bool b){
+	(void)b;
+	Listener* l = findListener(port);
+	if(l != NULL){
+		l->processor = p;
+		return;
+	}
+	if(m_listenerNum >= BB_UDP_HOST_LISTENER_NUM){
+		return;
+	}
+	int fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if(fd < 0){
+		return;
+	}
+	int on = 1;
+	setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+	setsockopt(fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on));
+	setsockopt(fd, IPPROTO_IP, IP_PKTINFO, &on, sizeof(on));//so the destination of each datagram is known
+	struct sockaddr_in a;
+	memset(&a, 0, sizeof(a));
+	a.sin_family = AF_INET;
+	a.sin_addr.s_addr = htonl(INADDR_ANY);
+	a.sin_port = htons(port);
+	if(bind(fd, (struct sockaddr*)&a, sizeof(a)) != 0){
+		close(fd);
+		return;
+	}
+	l = &m_listeners[m_listenerNum++];
+	l->fd = fd;
+	l->port = port;
+	l->processor = p;
+}
+
+/**
+ * This matches the function of the same name provided by the firmware network stack
+ * The host has no ethernet port to set up, so this does nothing
+ */
+void setEthernetPort(uint16_t a, uint16_t b){
+	(void)a;
+	(void)b;
+}
+
+/**
+ * gets a buffer to build a UDP datagram in
+ * This matches the function of the same name provided by the firmware network stack
+ * If all the buffers are in use then the completed ones are sent first
+ * @param mac - not used on the host
+ * @param ip - the IP address to send to
+ * @param port - the port to send to
+ * @param srcPort - the port to send from. This must be a port being listened to
+ * @param maxSize - set to the size of the buffer
+ * @return the buffer for the payload, or NULL if there isn't one
+ */
+uint8_t* startUdpPacket(uint8_t mac[6], uint32_t ip, uint16_t port, uint16_t srcPort, uint32_t* maxSize){
+	(void)mac;
+	*maxSize = 0;
+	Listener* l = findListener(srcPort);
+	if(l == NULL){
+		return NULL;
+	}
+	uint32_t i = 0;
+	while(i < TX_NUM && m_tx[i].state != TX_FREE){
+		++i;
+	}
+	if(i == TX_NUM){
+		flushBbUdpHost();
+		i = 0;
+		while(i < TX_NUM && m_tx[i].state != TX_FREE){
+			++i;
+		}
+		if(i == TX_NUM){
+			return NULL;
+		}
+	}
+	Tx* t = &m_tx[i];
+	t->state = TX_STARTED;
+	t->fd = l->fd;
+	memset(&t->to, 0, sizeof(t->to));
+	t->to.sin_family = AF_INET;
+	t->to.sin_addr.s_addr = htonl(ip);
+	t->to.sin_port = htons(port);
+	t->length = 0;
+	*maxSize = BB_UDP_HOST_MTU;
+	return m_txData[i];
+}
+
+/**
+ * marks a datagram as ready to send. It is sent with the rest of the batch
+ * This matches the function of the same name provided by the firmware network stack
+ * A datagram with no payload isn't sent, and its buffer is freed straight away
+ * @param data - the buffer returned by startUdpPacket()
+ * @param len - the number of bytes of payload
+ * @param b - not used on the host
+ */
+void completeUdpPacket(uint8_t* data, uint32_t len, bool b){
+	(void)b;
+	if(data < m_txData[0] || data >= m_txData[TX_NUM]){
+		return;//not one of ours
+	}
+	Tx* t = &m_tx[(data - m_txData[0]) / BB_UDP_HOST_MTU];
+	if(t->state != TX_STARTED){
+		return;
+	}
+	t->length = len > BB_UDP_HOST_MTU ? BB_UDP_HOST_MTU : len;
+	t->state = len == 0 ? TX_FREE : TX_READY;
+}
+
+/**
+ * sends any responses that have been completed but not yet sent
+ * The responses from each socket go in one sendmmsg() call
+ */
+void flushBbUdpHost(void){
+	for(uint32_t k = 0; k < m_listenerNum; ++k){
+		int fd = m_listeners[k].fd;
+		uint32_t n = 0;
+		for(uint32_t i = 0; i < TX_NUM; ++i){
+			Tx* t = &m_tx[i];
+			if(t->state != TX_READY || t->fd != fd){
+				continue;
+			}
+			m_txIov[n].iov_base = m_txData[i];
+			m_txIov[n].iov_len = t->length;
+			memset(&m_txMsgs[n], 0, sizeof(struct mmsghdr));
+			m_txMsgs[n].msg_hdr.msg_name = &t->to;
+			m_txMsgs[n].msg_hdr.msg_namelen = sizeof(t->to);
+			m_txMsgs[n].msg_hdr.msg_iov = &m_txIov[n];
+			m_txMsgs[n].msg_hdr.msg_iovlen = 1;
+			t->state = TX_FREE;//a datagram that can't be sent is dropped, as it would be on the wire
+			++n;
+		}
+		uint32_t sent = 0;
+		while(sent < n){
+			int r = sendmmsg(fd, &m_txMsgs[sent], n - sent, 0);
+			if(r <= 0){
+				break;
+			}
+			sent += (uint32_t)r;
+		}
+	}
+}
+
+/**
+ * waits for datagrams on the registered ports and hands each to its listener
+ * Each ready socket is drained a batch at a time with recvmmsg(), and any responses are sent in a batch after each
+ * @param timeoutMs - how long to wait for a datagram, in milliseconds. 0 to not wait, -1 to wait forever
+ * @return the number of datagrams received
+ */
+uint32_t pollBbUdpHost(int32_t timeoutMs){
+	struct pollfd fds[BB_UDP_HOST_LISTENER_NUM];
+	for(uint32_t k = 0; k < m_listenerNum; ++k){
+		fds[k].fd = m_listeners[k].fd;
+		fds[k].events = POLLIN;
+		fds[k].revents = 0;
+	}
+	if(poll(fds, m_listenerNum, timeoutMs) <= 0){
+		return 0;
+	}
+	uint32_t result = 0;
+	for(uint32_t k = 0; k < m_listenerNum; ++k){
+		if(fds[k].revents & POLLIN){
+			uint32_t n;
+			do {
+				n = receiveBatch(&m_listeners[k]);
+				result += n;
+				flushBbUdpHost();
+			} while(n == BB_UDP_HOST_BATCH);//there may be more waiting
+		}
+	}
+	return result;
+}
+
+/**
+ * gets the number of datagrams received that were bigger than BB_UDP_HOST_MTU
+ * These are still passed to the listener, cut short, so a blueberry receiver also counts them as truncated packets
+ * @return the count, which only ever goes up
+ */
+uint32_t getBbUdpHostTruncatedNum(void){
+	return m_truncatedNum;
+}
+
+/**
+ * closes all the sockets and forgets the listeners
+ */
+void closeBbUdpHost(void){
+	for(uint32_t k = 0; k < m_listenerNum; ++k){
+		close(m_listeners[k].fd);
+	}
+	m_listenerNum = 0;
+	memset(m_tx, 0, sizeof(m_tx));
+}
+
+/**
+ * receives one batch of datagrams from a socket, without waiting, and hands each to the listener
+ * @param l - the listener
+ * @return the number of datagrams received
+ */
+static uint32_t receiveBatch(Listener* l){
+	for(uint32_t i = 0; i < BB_UDP_HOST_BATCH; ++i){
+		m_rxIov[i].iov_base = m_rxData[i];
+		m_rxIov[i].iov_len = BB_UDP_HOST_MTU;
+		memset(&m_rxMsgs[i], 0, sizeof(struct mmsghdr));
+		m_rxMsgs[i].msg_hdr.msg_name = &m_rxFrom[i];
+		m_rxMsgs[i].msg_hdr.msg_namelen = sizeof(m_rxFrom[i]);
+		m_rxMsgs[i].msg_hdr.msg_iov = &m_rxIov[i];
+		m_rxMsgs[i].msg_hdr.msg_iovlen = 1;
+		m_rxMsgs[i].msg_hdr.msg_control = m_rxControl[i];
+		m_rxMsgs[i].msg_hdr.msg_controllen = sizeof(m_rxControl[i]);
+	}
+	int r = recvmmsg(l->fd, m_rxMsgs, BB_UDP_HOST_BATCH, MSG_DONTWAIT, NULL);
+	if(r <= 0){
+		return 0;
+	}
+	uint8_t mac[6] = {0};//the host doesn't see the ethernet header
+	for(int i = 0; i < r; ++i){
+		struct msghdr* h = &m_rxMsgs[i].msg_hdr;
+		if(h->msg_flags & MSG_TRUNC){
+			++m_truncatedNum;
+		}
+		if(l->processor != NULL){
+			//a datagram bigger than the buffer is still passed on, cut short, so that the receiver counts it as a truncated packet
+			uint32_t len = m_rxMsgs[i].msg_len > BB_UDP_HOST_MTU ? BB_UDP_HOST_MTU : m_rxMsgs[i].msg_len;
+			(*l->processor)(mac, ntohl(m_rxFrom[i].sin_addr.s_addr), ntohs(m_rxFrom[i].sin_port), getDestIp(h), l->port, m_rxData[i], len);
+			freeStartedBuffers();
+		}
+	}
+	return (uint32_t)r;
+}
+
+/**
+ * frees the buffers that a listener started but never completed, because it had nothing to send
+ * The firmware network stack reclaims these itself, so the receiver only completes a buffer that has a payload
+ */
+static void freeStartedBuffers(void){
+	for(uint32_t i = 0; i < TX_NUM; ++i){
+		if(m_tx[i].state == TX_STARTED){
+			m_tx[i].state = TX_FREE;
+		}
+	}
+}
+
+/**
+ * gets the IP address that a datagram was sent to, so that broadcasts can be told apart
+ * @param h - the header of the received datagram
+ * @return the destination IP address, or 0 if it isn't known
+ */
+static uint32_t getDestIp(struct msghdr* h){
+	for(struct cmsghdr* c = CMSG_FIRSTHDR(h); c != NULL; c = CMSG_NXTHDR(h, c)){
+		if(c->cmsg_level == IPPROTO_IP && c->cmsg_type == IP_PKTINFO){
+			struct in_pktinfo info;
+			memcpy(&info, CMSG_DATA(c), sizeof(info));
+			return ntohl(info.ipi_addr.s_addr);
+		}
+	}
+	return 0;
+}
+
+/**
+ * finds the listener on the specified port
+ * @param port - the port
+ * @return the listener, or NULL if there isn't one
+ */
+static Listener* findListener(uint16_t port){
+	for(uint32_t k = 0; k < m_listenerNum; ++k){
+		if(m_listeners[k].port == port){
+			return &m_listeners[k];
+		}
+	}
+	return NULL;
+}
+
+#endif //__linux__
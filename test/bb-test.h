@@ -0,0 +1,136 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+
+#ifndef TEST_BB_TEST_H_
+#define TEST_BB_TEST_H_
+
+/**
+ * Helpers shared by the tests and benchmarks of the blueberry library
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include <blueberry-transcoder.h>
+#include <blueberry-parser.h>
+
+#include <stdio.h>
+#include <string.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define MAKE_TEST_KEY(mod, msg) ((((uint32_t)(mod)) << 16) | ((uint32_t)(msg)))
+
+/**
+ * checks a condition and counts and reports it if it is false, without stopping the test
+ */
+#define CHECK(c) checkBbTest((c), #c, __FILE__, __LINE__)
+
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint32_t m_testFailures = 0;
+
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+/**
+ * counts and reports a failed check
+ * @param ok - the result of the check
+ * @param what - the text of the check
+ * @param file - where the check is
+ * @param line - where the check is
+ * @return ok
+ */
+static inline int checkBbTest(int ok, const char* what, const char* file, int line){
+	if(!ok){
+		++m_testFailures;
+		if(m_testFailures <= 20){
+			printf("%s:%d: check failed: %s\n", file, line, what);
+		}
+	}
+	return ok;
+}
+
+/**
+ * reports the result of the test
+ * @param name - the name of the test
+ * @return the exit code of the test program
+ */
+static inline int finishBbTest(const char* name){
+	printf("%s: %s (%u failures)\n", name, m_testFailures == 0 ? "passed" : "FAILED", m_testFailures);
+	return m_testFailures == 0 ? 0 : 1;
+}
+
+/**
+ * sets up a Bb over the specified memory, with no packet in it
+ * @param bb - the Bb to set up
+ * @param buffer - the memory
+ * @param size - the number of bytes of memory
+ * @param start - where the packet will start
+ */
+static inline void initBbTestBuffer(Bb* bb, uint8_t* buffer, uint32_t size, uint32_t start){
+	memset(bb, 0, sizeof(Bb));
+	bb->buffer = buffer;
+	bb->bufferLength = size;
+	bb->start = start;
+	updateBbLinear(bb);
+}
+
+/**
+ * adds a message with the specified key to the packet being built, filled with a pattern
+ * @param bb - the buffer with the packet
+ * @param key - the module/message key of the message
+ * @param length - the length of the message in bytes, a multiple of 4 and at least 8
+ */
+static inline void addBbTestMessage(Bb* bb, uint32_t key, uint32_t length){
+	uint32_t msg = bb->length;
+	bb->length += length;
+	updateBbLinear(bb);
+	setBbUint32(bb, (BbBlock)msg, 0, key);
+	setBbUint16(bb, (BbBlock)msg, 4, (uint16_t)(length/4));
+	setBbUint8(bb, (BbBlock)msg, 6, 1);
+	for(uint32_t i = 8; i < length; i += 4){
+		setBbUint32(bb, (BbBlock)msg, (BbBlock)i, key*0x9e3779b1u + i);
+	}
+}
+
+/**
+ * builds a packet of equal messages, with keys counting up from the first key
+ * @param bb - the buffer to build the packet in, with its start set
+ * @param firstKey - the key of the first message
+ * @param messageNum - the number of messages
+ * @param messageLength - the length of each message in bytes, a multiple of 4 and at least 8
+ * @return the length of the packet
+ */
+static inline uint32_t makeBbTestPacket(Bb* bb, uint32_t firstKey, uint32_t messageNum, uint32_t messageLength){
+	startBbPacket(bb);
+	for(uint32_t k = 0; k < messageNum; ++k){
+		addBbTestMessage(bb, firstKey + k, messageLength);
+	}
+	finishBbPacket(bb);
+	return bb->length;
+}
+
+#endif /* TEST_BB_TEST_H_ */
@@ -0,0 +1,630 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Benchmarks of the hot paths of the blueberry library, reporting ns/op, bytes/s and cycles/byte
+ * Each is run for a range of packet sizes, and with the packet either linear or wrapping round the end of its ring
+ * Cycles are those of the x86 time stamp counter, which runs at a fixed rate, so they are only shown on x86
+ * Run with --quick to do a few iterations of each, to check that it works
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-receiver.h>
+#include <blueberry-message.h>
+#include <byteQ.h>
+
+#include <stdlib.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define RING_SIZE (16384)
+#define ODD_RING_SIZE (12000)//not a power of two, so it is wrapped with a modulo
+#define SIZE_NUM (4)
+#define MAX_KEYS (100)//the most builders benchBuild() registers
+#define BIG_RING_SIZE (81920)//room for a sequence of 16k 32-bit elements
+#define SEQUENCE_MAX (16384)
+#define PARSE_KEY(k) MAKE_TEST_KEY(1 + (k)/DISPATCH_PAGE_SIZE, (k)%DISPATCH_PAGE_SIZE)//fills each module's dispatch page
+#define TABLE_KEYS (1000)//the most parsers benchParse() dispatches to, registered, in a constant table or by lookup()
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static const uint32_t m_sizes[SIZE_NUM] = {64, 512, 1472, 4096};
+static uint8_t m_ring[RING_SIZE];
+static uint32_t m_reps = 1;//a multiplier for the number of repetitions
+static volatile uint32_t m_sink;//keeps the results from being optimised away
+static uint32_t m_built = 0;
+static BbProcessorEntry m_parserTable[TABLE_KEYS];
+static BbProcessorKeyValue m_lookupTable[TABLE_KEYS];
+static uint32_t m_parsed = 0;//the number of messages parseNothing() has been called for
+static uint8_t m_bigRing[BIG_RING_SIZE];
+static uint32_t m_elements[SEQUENCE_MAX];
+static double m_cyclesPerNs = 0;//the rate of the cycle counter, 0 if there isn't one
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static uint64_t getNs(void);
+static double measureCyclesPerNs(void);
+static void report(const char* name, uint32_t size, const char* wrap, uint32_t ops, uint64_t ns, uint64_t bytes);
+static uint32_t placePacket(Bb* bb, uint32_t size, bool wrap, uint32_t messageLength);
+static void benchAccessors(void);
+static void benchMasked(void);
+static void benchCrc(void);
+static void benchReceive(void);
+static bool receiveEachByte(BbContext* ctx, Bb* buf, ByteQ* q, uint32_t n);
+static void benchParse(void);
+static void parseWithLookup(BbContext* ctx, Bb* bb, uint32_t num);
+static BbProcessor lookup(const BbProcessorKeyValue* kvs, uint32_t num, uint32_t key);
+static void benchBuild(void);
+static void benchSequences(void);
+static void parseNothing(Bb* bb, BbBlock msg);
+static void buildMessage(Bb* bb, BbBlock msg);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(int argc, char** argv){
+	m_reps = (argc > 1 && strcmp(argv[1], "--quick") == 0) ? 1 : 100;
+	initBbParser();
+	m_cyclesPerNs = measureCyclesPerNs();
+	printf("%-30s %6s %-6s %12s %12s %10s\n", "benchmark", "bytes", "wrap", "ns/op", "MB/s", "cycles/B");
+	benchAccessors();
+	benchMasked();
+	benchCrc();
+	benchReceive();
+	benchParse();
+	benchBuild();
+	benchSequences();
+	return 0;
+}
+
+/**
+ * reads and writes every word of a packet through the checked accessors
+ */
+static void benchAccessors(void){
+	for(uint32_t s = 0; s < SIZE_NUM; ++s){
+		for(uint32_t w = 0; w < 2; ++w){
+			Bb bb;
+			uint32_t size = m_sizes[s];
+			placePacket(&bb, size, w != 0, 16);
+			uint32_t reps = 20*m_reps*(4096/size);
+			uint32_t sum = 0;
+			uint64_t t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				for(uint32_t i = 0; i < size; i += 4){
+					sum += getBbUint32(&bb, 0, (BbBlock)i);
+				}
+			}
+			t = getNs() - t;
+			report("getBbUint32", size, w ? "wrap" : "linear", reps*(size/4), t, (uint64_t)reps*size);
+
+			t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				for(uint32_t i = 0; i < size; i += 4){
+					setBbUint32(&bb, 0, (BbBlock)i, i + r);
+				}
+			}
+			t = getNs() - t;
+			report("setBbUint32", size, w ? "wrap" : "linear", reps*(size/4), t, (uint64_t)reps*size);
+
+			if(!w){
+				t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					for(uint32_t i = 0; i < size; i += 4){
+						sum += getBbUint32Fast(&bb, 0, (BbBlock)i);
+					}
+				}
+				t = getNs() - t;
+				report("getBbUint32Fast", size, "linear", reps*(size/4), t, (uint64_t)reps*size);
+			}
+			m_sink = sum;
+		}
+	}
+}
+
+/**
+ * reads packets that wrap: with the accessors in a ring that is a power of two and in one that isn't,
+ * and with the masked accessors, which only work in the power of two ring
+ */
+static void benchMasked(void){
+	for(uint32_t s = 0; s < SIZE_NUM; ++s){
+		Bb bb;
+		Bb odd;
+		uint32_t size = m_sizes[s];
+		placePacket(&bb, size, true, 16);
+		initBbTestBuffer(&odd, m_ring, ODD_RING_SIZE, ODD_RING_SIZE - size/2);
+		makeBbTestPacket(&odd, MAKE_TEST_KEY(7, 0), size/16, 16);
+		uint32_t reps = 20*m_reps*(4096/size);
+		uint32_t sum = 0;
+
+		uint64_t t = getNs();
+		for(uint32_t r = 0; r < reps; ++r){
+			for(uint32_t i = 0; i < size; i += 4){
+				sum += getBbUint32(&bb, 0, (BbBlock)i);
+			}
+		}
+		t = getNs() - t;
+		report("getBbUint32 pow2 ring", size, "wrap", reps*(size/4), t, (uint64_t)reps*size);
+
+		t = getNs();
+		for(uint32_t r = 0; r < reps; ++r){
+			for(uint32_t i = 0; i < size; i += 4){
+				sum += getBbUint32(&odd, 0, (BbBlock)i);
+			}
+		}
+		t = getNs() - t;
+		report("getBbUint32 odd ring", size, "wrap", reps*(size/4), t, (uint64_t)reps*size);
+
+		if(isBbMasked(&bb)){
+			t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				for(uint32_t i = 0; i < size; i += 4){
+					sum += getBbUint32Masked(&bb, 0, (BbBlock)i);
+				}
+			}
+			t = getNs() - t;
+			report("getBbUint32Masked", size, "wrap", reps*(size/4), t, (uint64_t)reps*size);
+		}
+		m_sink = sum;
+	}
+}
+
+/**
+ * computes the crc of a whole packet
+ */
+static void benchCrc(void){
+	for(uint32_t s = 0; s < SIZE_NUM; ++s){
+		for(uint32_t w = 0; w < 2; ++w){
+			Bb bb;
+			uint32_t size = m_sizes[s];
+			placePacket(&bb, size, w != 0, 16);
+			uint32_t reps = 20*m_reps*(4096/size);
+			uint32_t sum = 0;
+			uint64_t t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				sum += computeCrc(&bb, 8, (BbBlock)size);
+			}
+			t = getNs() - t;
+			report("computeCrc", size, w ? "wrap" : "linear", reps, t, (uint64_t)reps*size);
+			m_sink = sum;
+		}
+	}
+}
+
+/**
+ * receives a packet that is already in the queue, checking its crc and walking its messages
+ * This is done n bytes per call to the receive routine, for a few n and for the whole packet at once,
+ * both with transceiveBrPacketN() and with a copy of the receive loop from before it jumped to the declared packet length
+ */
+static void benchReceive(void){
+	static const uint32_t chunks[] = {16, 64, 0};//0 for the whole packet
+	BbContext* ctx = getBbDefaultContext();
+	static uint8_t outMem[256];
+	for(uint32_t s = 0; s < SIZE_NUM; ++s){
+		for(uint32_t w = 0; w < 2; ++w){
+			for(uint32_t c = 0; c < sizeof(chunks)/sizeof(chunks[0]); ++c){
+				uint32_t size = m_sizes[s];
+				if(chunks[c] >= size){
+					continue;//the same as the whole packet
+				}
+				Bb bb;
+				uint32_t n = chunks[c] != 0 ? chunks[c] : size;
+				placePacket(&bb, size, w != 0, 64);
+				ByteQ inQ = {m_ring, RING_SIZE, 0, 0};
+				ByteQ outQ = {outMem, sizeof(outMem), 0, 0};
+				Bb inP;
+				memset(&inP, 0, sizeof(inP));
+				uint32_t reps = 20*m_reps*(4096/size);
+				char name[40];
+
+				uint32_t good = 0;
+				uint64_t t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					inQ.front = bb.start;
+					inQ.back = (bb.start + size) % RING_SIZE;
+					good += receiveEachByte(ctx, &inP, &inQ, n);
+				}
+				t = getNs() - t;
+				snprintf(name, sizeof(name), "receive each byte n=%u", n);
+				report(name, size, w ? "wrap" : "linear", reps, t, (uint64_t)reps*size);
+				if(good != reps){
+					printf("  only %u of %u packets were received\n", good, reps);
+				}
+
+				good = 0;
+				t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					inQ.front = bb.start;
+					inQ.back = (bb.start + size) % RING_SIZE;
+					good += transceiveBrPacketNCtx(ctx, &inP, &inQ, &outQ, n);
+				}
+				t = getNs() - t;
+				snprintf(name, sizeof(name), "transceiveBrPacketN n=%u", n);
+				report(name, size, w ? "wrap" : "linear", reps, t, (uint64_t)reps*size);
+				if(good != reps){
+					printf("  only %u of %u packets were received\n", good, reps);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * the receive loop from before blueberryReceive() jumped to the declared packet length, as the baseline for benchReceive()
+ * Every byte is counted and checked on its own, then a good packet is parsed and discarded as transceiveBrPacketN() does
+ * @param ctx - the context to parse the packet in
+ * @param buf - the buffer for the packet, also the state of the receive loop
+ * @param q - the queue with the bytes
+ * @param n - the maximum number of bytes to take at each pass of the loop
+ * @return true if a valid packet was received
+ */
+static bool receiveEachByte(BbContext* ctx, Bb* buf, ByteQ* q, uint32_t n){
+	while(isByteQNotEmpty(q)){
+		bool fail = false;
+		if(buf->length == 0){
+			buf->buffer = q->buffer;
+			buf->bufferLength = q->bufferSize;
+			buf->start = q->front;
+			updateBbLinear(buf);
+			resetBbRunningCrc(buf);
+		}
+		uint32_t m = getBytesUsed(q) - buf->length;
+		if(m > n){
+			m = n;
+		}
+		for(uint32_t i = 0; i < m; ++i){
+			++(buf->length);
+			if(!minBbLengthCheck(buf)){
+				if(!checkBbPreamble(buf)){
+					fail = true;
+				}
+			} else if(checkBbLength(buf)){
+				updateBbLinear(buf);
+				if(checkBbRunningCrc(buf)){
+					parseBbPacketCtx(ctx, buf);
+					discardFromByteQ(q, buf->length);
+					buf->length = 0;
+					return true;
+				}
+				fail = true;
+			}
+			if(fail){
+				discardFromByteQ(q, buf->length);
+				buf->length = 0;
+				buf->start = q->front;
+				updateBbLinear(buf);
+				resetBbRunningCrc(buf);
+				fail = false;
+			}
+		}
+		updateBbRunningCrc(buf);
+		if(getBytesUsed(q) <= buf->length){
+			break;
+		}
+	}
+	return false;
+}
+
+/**
+ * parses a packet with one message for each of many keys, with the parsers registered, in a constant table,
+ * or in a sorted array searched by lookup() as the parser did before it had the dispatch index
+ * Registered parsers are found through the dispatch index, and the table by binary search
+ */
+static void benchParse(void){
+	static const uint32_t keyNums[] = {10, 100, TABLE_KEYS};
+	static const char* const modes[] = {"keys", "table", "lookup"};
+	for(uint32_t k = 0; k < TABLE_KEYS; ++k){
+		m_parserTable[k].key = PARSE_KEY(k);//these go up with k, so the table is sorted
+		m_parserTable[k].processor = parseNothing;
+		m_lookupTable[k].key = m_parserTable[k].key;
+		m_lookupTable[k].parser = parseNothing;
+	}
+	for(uint32_t n = 0; n < sizeof(keyNums)/sizeof(keyNums[0]); ++n){
+		for(uint32_t mode = 0; mode < sizeof(modes)/sizeof(modes[0]); ++mode){
+			static BbContext ctx;
+			uint32_t keyNum = keyNums[n];
+			if(mode == 0 && keyNum > PROCESSOR_NUM){
+				continue;//too many to register
+			}
+			initBbContext(&ctx);
+			if(mode == 0){
+				for(uint32_t k = 0; k < keyNum; ++k){
+					registerBbParserCtx(&ctx, PARSE_KEY(k), parseNothing);
+				}
+			} else if(mode == 1){
+				setBbParserTableCtx(&ctx, m_parserTable, keyNum);
+			}
+			Bb bb;
+			initBbTestBuffer(&bb, m_ring, RING_SIZE, 0);
+			startBbPacket(&bb);
+			for(uint32_t k = 0; k < keyNum; ++k){
+				addBbTestMessage(&bb, PARSE_KEY(k), 12);
+			}
+			finishBbPacket(&bb);
+			uint32_t reps = 200*m_reps;
+			m_parsed = 0;
+			uint64_t t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				if(mode == 2){
+					parseWithLookup(&ctx, &bb, keyNum);
+				} else {
+					parseBbPacketCtx(&ctx, &bb);
+				}
+			}
+			t = getNs() - t;
+			char name[40];
+			snprintf(name, sizeof(name), "parseBbPacket %u %s", keyNum, modes[mode]);
+			report(name, bb.length, "linear", reps*keyNum, t, (uint64_t)reps*bb.length);
+			if(m_parsed != reps*keyNum){
+				printf("  only %u of %u messages were parsed\n", m_parsed, reps*keyNum);
+			}
+		}
+	}
+}
+
+/**
+ * parses a packet the way parseBbPacket() did before the dispatch index, finding each parser with lookup()
+ * @param ctx - the context to queue the received keys in
+ * @param bb - the packet
+ * @param num - the number of parsers at the start of m_lookupTable to search
+ */
+static void parseWithLookup(BbContext* ctx, Bb* bb, uint32_t num){
+	BbMessageIterator it;
+	BbMessageView v;
+	startBbMessageIterator(&it, bb);
+	while(nextBbMessage(&it, &v)){
+		queueBbMessageCtx(ctx, v.key);
+		if(!isBbMessageEmpty(bb, v.msg)){
+			BbProcessor p = lookup(m_lookupTable, num, v.key);
+			if(p != NULL){
+				(*p)(bb, v.msg);
+			}
+		}
+	}
+}
+
+/**
+ * finds a parser by binary search of a sorted array, as the parser did before the dispatch index
+ * @param kvs - the parsers, sorted by key
+ * @param num - the number of parsers
+ * @param key - the key to look up
+ * @return the parser, or NULL if there isn't one
+ */
+static BbProcessor lookup(const BbProcessorKeyValue* kvs, uint32_t num, uint32_t key){
+	uint32_t min = 0;
+	uint32_t max = num;//one past the last one that could match
+	while(min < max){
+		uint32_t i = (min + max) / 2;
+		if(kvs[i].key == key){
+			return kvs[i].parser;
+		} else if(kvs[i].key < key){
+			min = i + 1;
+		} else {
+			max = i;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * builds a packet with one message from each of many registered builders
+ */
+static void benchBuild(void){
+	static const uint32_t keyNums[] = {10, 50, MAX_KEYS};
+	for(uint32_t n = 0; n < sizeof(keyNums)/sizeof(keyNums[0]); ++n){
+		for(uint32_t w = 0; w < 2; ++w){
+			static BbContext ctx;
+			uint32_t keyNum = keyNums[n];
+			initBbContext(&ctx);
+			for(uint32_t k = 0; k < keyNum; ++k){
+				registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(1 + k/20, k%20), buildMessage);
+			}
+			uint32_t reps = 200*m_reps;
+			uint32_t bytes = 0;
+			uint64_t t = getNs();
+			for(uint32_t r = 0; r < reps; ++r){
+				for(uint32_t k = 0; k < keyNum; ++k){
+					queueBbMessageCtx(&ctx, MAKE_TEST_KEY(1 + k/20, k%20));
+				}
+				Bb bb;
+				initBbTestBuffer(&bb, m_ring, RING_SIZE, w ? RING_SIZE - 8 - keyNum*8 : 0);
+				makeBbPacketWithQueuedMessagesCtx(&ctx, &bb);
+				bytes += bb.length;
+			}
+			t = getNs() - t;
+			char name[40];
+			snprintf(name, sizeof(name), "makeBbPacket %u keys", keyNum);
+			report(name, bytes/reps, w ? "wrap" : "linear", reps, t, bytes);
+		}
+	}
+}
+
+/**
+ * reads and writes a sequence of 1k and 16k elements of each width, in bulk and one element at a time
+ * A sequence of 16k 32-bit elements needs more than 64KB, so it is only run with BB_LARGE_PACKETS
+ */
+static void benchSequences(void){
+	static const uint32_t counts[] = {1024, SEQUENCE_MAX};
+	static const uint32_t widths[] = {1, 2, 4};
+	for(uint32_t c = 0; c < sizeof(counts)/sizeof(counts[0]); ++c){
+		for(uint32_t wi = 0; wi < sizeof(widths)/sizeof(widths[0]); ++wi){
+			uint32_t count = counts[c];
+			uint32_t width = widths[wi];
+			uint32_t size = count*width;
+			if(!BB_LARGE_PACKETS && size + 64 > 0xffff){
+				continue;
+			}
+			for(uint32_t w = 0; w < 2; ++w){
+				Bb bb;
+				initBbTestBuffer(&bb, m_bigRing, BIG_RING_SIZE, w ? (BIG_RING_SIZE - size/2) & ~3u : 0);
+				startBbPacket(&bb);
+				BbBlock msg = (BbBlock)bb.length;
+				bb.length += 12;
+				updateBbLinear(&bb);
+				setBbUint32(&bb, msg, 0, MAKE_TEST_KEY(1, 1));
+				initBbSequence(&bb, msg, 8, width, count);
+				finishBbPacket(&bb);
+
+				uint32_t reps = m_reps*(SEQUENCE_MAX*4/size);
+				uint32_t sum = 0;
+				char name[40];
+				uint64_t t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					if(width == 1){
+						setBbSequenceUint8s(&bb, msg, 8, 0, (const uint8_t*)m_elements, count);
+					} else if(width == 2){
+						setBbSequenceUint16s(&bb, msg, 8, 0, (const uint16_t*)m_elements, count);
+					} else {
+						setBbSequenceUint32s(&bb, msg, 8, 0, m_elements, count);
+					}
+				}
+				t = getNs() - t;
+				snprintf(name, sizeof(name), "setBbSequenceUint%us %u", width*8, count);
+				report(name, size, w ? "wrap" : "linear", reps*count, t, (uint64_t)reps*size);
+
+				t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					if(width == 1){
+						getBbSequenceUint8s(&bb, msg, 8, 0, (uint8_t*)m_elements, count);
+					} else if(width == 2){
+						getBbSequenceUint16s(&bb, msg, 8, 0, (uint16_t*)m_elements, count);
+					} else {
+						getBbSequenceUint32s(&bb, msg, 8, 0, m_elements, count);
+					}
+					sum += m_elements[r % (count*width/4)];
+				}
+				t = getNs() - t;
+				snprintf(name, sizeof(name), "getBbSequenceUint%us %u", width*8, count);
+				report(name, size, w ? "wrap" : "linear", reps*count, t, (uint64_t)reps*size);
+
+				//the same, an element at a time as code without the bulk accessors would
+				t = getNs();
+				for(uint32_t r = 0; r < reps; ++r){
+					for(uint32_t k = 0; k < count; ++k){
+						BbBlock e = getBbSequenceElementIndex(&bb, msg, 8, k);
+						if(width == 1){
+							sum += getBbUint8(&bb, msg, e);
+						} else if(width == 2){
+							sum += getBbUint16(&bb, msg, e);
+						} else {
+							sum += getBbUint32(&bb, msg, e);
+						}
+					}
+				}
+				t = getNs() - t;
+				snprintf(name, sizeof(name), "getBbUint%u each %u", width*8, count);
+				report(name, size, w ? "wrap" : "linear", reps*count, t, (uint64_t)reps*size);
+				m_sink = sum;
+			}
+		}
+	}
+}
+
+/**
+ * builds a packet of the specified size in the ring, either at the start or straddling the end
+ * @param bb - set to the packet
+ * @param size - the size of the packet
+ * @param wrap - true to have the packet wrap round the end of the ring halfway through
+ * @param messageLength - the length of each message, with any remainder added to the last one
+ * @return the length of the packet
+ */
+static uint32_t placePacket(Bb* bb, uint32_t size, bool wrap, uint32_t messageLength){
+	initBbTestBuffer(bb, m_ring, RING_SIZE, wrap ? RING_SIZE - size/2 : 0);
+	startBbPacket(bb);
+	uint32_t key = MAKE_TEST_KEY(7, 0);
+	while(bb->length < size){
+		uint32_t n = size - bb->length;
+		addBbTestMessage(bb, key++, n < 2*messageLength ? n : messageLength);
+	}
+	finishBbPacket(bb);
+	return bb->length;
+}
+
+/**
+ * a parser that only reads the key, as the cheapest real parser would
+ */
+static void parseNothing(Bb* bb, BbBlock msg){
+	m_sink = getBbMessageKey(bb, msg);
+	++m_parsed;
+}
+
+/**
+ * builds a 16 byte message
+ */
+static void buildMessage(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, MAKE_TEST_KEY(1, m_built++ & 0xff), 16);
+	(void)msg;
+}
+
+/**
+ * prints one line of results
+ * @param name - what was measured
+ * @param size - the size of the packet
+ * @param wrap - where the packet was in its ring
+ * @param ops - the number of operations timed
+ * @param ns - how long they took
+ * @param bytes - the number of bytes they processed
+ */
+static void report(const char* name, uint32_t size, const char* wrap, uint32_t ops, uint64_t ns, uint64_t bytes){
+	double perOp = ops ? (double)ns/ops : 0;
+	double rate = ns ? (double)bytes*1000.0/(double)ns : 0;//bytes per ns is GB/s, so this is MB/s
+	printf("%-30s %6u %-6s %12.2f %12.1f", name, size, wrap, perOp, rate);
+	if(m_cyclesPerNs != 0 && bytes != 0){
+		printf(" %10.2f\n", (double)ns*m_cyclesPerNs/(double)bytes);
+	} else {
+		printf(" %10s\n", "-");
+	}
+}
+
+/**
+ * measures the rate of the cycle counter against the monotonic clock
+ * @return the number of cycles per nanosecond, or 0 if there is no cycle counter
+ */
+static double measureCyclesPerNs(void){
+#if defined(__x86_64__) || defined(__i386__)
+	uint64_t t = getNs();
+	uint64_t c = __rdtsc();
+	while(getNs() - t < 20000000){
+		//spin for 20 ms
+	}
+	return (double)(__rdtsc() - c)/(double)(getNs() - t);
+#else
+	return 0;
+#endif
+}
+
+/**
+ * gets the time from the monotonic clock
+ * @return the time in nanoseconds
+ */
+static uint64_t getNs(void){
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000u + (uint64_t)ts.tv_nsec;
+}
@@ -0,0 +1,189 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Checks the CRC engine against feeding crc1021P32() one word at a time, with the bytes of each word taken in
+ * buffer order as the least significant byte first.
+ * Every span length up to past the largest packet is checked at every alignment, and every packet length is
+ * checked at every start of a ring, so each way that a packet can wrap is covered.
+ * The words are also checked against literal values, so that a path that reads them in the byte order of a big endian
+ * target rather than that of the packet fails.
+ * The test is built against each CRC engine, see CMakeLists.txt
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-crc.h>
+#include <crc1021.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define SPAN_WORDS (1100)//longer than a 4 kB packet, so every fold of the carry-less path is reached
+#define RING_SIZE (602)//not a multiple of 4, so words straddle the wrap
+#define POW2_RING_SIZE (512)//wrapped with a mask
+#define MIRROR_SIZE (64)
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint8_t m_data[SPAN_WORDS * 4 + 3];
+static uint8_t m_ring[RING_SIZE + MIRROR_SIZE];
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static uint16_t referenceWord(uint16_t crc, const uint8_t* data);
+static void testSpans(void);
+static void testRing(uint32_t size, uint32_t mirror);
+static void testByteOrder(void);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	uint32_t x = 0x12345678;
+	for(uint32_t i = 0; i < sizeof(m_data); ++i){
+		x = x*1103515245u + 12345u;
+		m_data[i] = (uint8_t)(x >> 16);
+	}
+	//before init every CRC is taken a word at a time, and is still right
+	uint16_t expected = 0xffff;
+	for(uint32_t n = 0; n < 100; ++n){
+		expected = referenceWord(expected, &m_data[n * 4]);
+	}
+	CHECK(updateBbCrc(0xffff, m_data, 100) == expected);
+	initBbCrc();
+	initBbCrc();//a second call leaves the tables alone
+	testSpans();
+	testRing(RING_SIZE, 0);
+	testRing(POW2_RING_SIZE, 0);
+	testRing(RING_SIZE, MIRROR_SIZE);
+	testByteOrder();
+	return finishBbTest("test-crc");
+}
+
+/**
+ * folds one word into the crc the plain way
+ * @param crc - the running crc
+ * @param data - the 4 bytes of the word, in buffer order
+ * @return the updated crc
+ */
+static uint16_t referenceWord(uint16_t crc, const uint8_t* data){
+	uint32_t w = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+	crc1021P32(&crc, w);
+	return crc;
+}
+
+/**
+ * checks updateBbCrc() for every length of span up to SPAN_WORDS, at each alignment and from a few starting crcs
+ */
+static void testSpans(void){
+	static const uint16_t seeds[] = {0x0000, 0xffff, 0x1d0f, 0x8001};
+	for(uint32_t offset = 0; offset < 4; ++offset){
+		const uint8_t* d = &m_data[offset];
+		for(uint32_t s = 0; s < sizeof(seeds)/sizeof(seeds[0]); ++s){
+			uint16_t expected = seeds[s];
+			for(uint32_t n = 0; n <= SPAN_WORDS; ++n){
+				if(!CHECK(updateBbCrc(seeds[s], d, n) == expected)){
+					printf("  offset %u, seed 0x%04x, %u words\n", offset, seeds[s], n);
+				}
+				if(n < SPAN_WORDS){
+					expected = referenceWord(expected, &d[n * 4]);
+				}
+			}
+		}
+	}
+}
+
+/**
+ * checks computeCrc() for every packet length that fits in a ring, starting at every index of the ring
+ * @param size - the size of the ring
+ * @param mirror - the number of bytes past the end of the ring that mirror its start
+ */
+static void testRing(uint32_t size, uint32_t mirror){
+	for(uint32_t i = 0; i < size; ++i){
+		m_ring[i] = m_data[i];
+	}
+	for(uint32_t i = 0; i < mirror; ++i){
+		m_ring[size + i] = m_ring[i];
+	}
+	Bb bb;
+	for(uint32_t start = 0; start < size; ++start){
+		initBbTestBuffer(&bb, m_ring, size, start);
+		bb.mirrorLength = mirror;
+		uint16_t expected;
+		resetCrc1021P(&expected);
+		for(uint32_t length = 0; length + 4 <= size; length += 4){
+			bb.length = length;
+			updateBbLinear(&bb);
+			uint16_t crc = computeCrc(&bb, 0, (BbBlock)length);
+			uint16_t e = expected;
+			getCrc1021P(&e);
+			if(!CHECK(crc == e)){
+				printf("  ring %u, mirror %u, start %u, length %u\n", size, mirror, start, length);
+			}
+			uint8_t w[4];
+			for(uint32_t k = 0; k < 4; ++k){
+				w[k] = m_ring[(start + length + k) % size];
+			}
+			expected = referenceWord(expected, w);
+		}
+	}
+}
+
+/**
+ * checks that every path takes the words of the packet little endian, with literal word values rather than ones read
+ * from the buffer. The packet is long enough for the carry-less path, and is placed so that one word straddles the wrap
+ */
+static void testByteOrder(void){
+	uint8_t ring[RING_SIZE];
+	uint32_t start = RING_SIZE - 70;//the ring ends 2 bytes into the 18th word
+	uint32_t wordNum = 40;
+	uint16_t expected;
+	resetCrc1021P(&expected);
+	for(uint32_t n = 0; n < wordNum; ++n){
+		for(uint32_t k = 0; k < 4; ++k){
+			ring[(start + n * 4 + k) % RING_SIZE] = (uint8_t)(n * 4 + k + 1);
+		}
+		uint32_t w = 0x04030201u + n * 0x04040404u;//bytes 1, 2, 3, 4 of the first word are 0x04030201 little endian
+		crc1021P32(&expected, w);
+	}
+	getCrc1021P(&expected);
+
+	Bb bb;
+	initBbTestBuffer(&bb, ring, RING_SIZE, start);
+	bb.length = wordNum * 4;
+	updateBbLinear(&bb);
+	CHECK(computeCrc(&bb, 0, (BbBlock)bb.length) == expected);
+
+	initBbTestBuffer(&bb, ring, RING_SIZE, 0);//the part after the wrap on its own, through the contiguous path
+	bb.length = RING_SIZE;
+	updateBbLinear(&bb);
+	uint16_t tail;
+	resetCrc1021P(&tail);
+	for(uint32_t n = 18; n < wordNum; ++n){
+		crc1021P32(&tail, 0x04030201u + n * 0x04040404u);
+	}
+	getCrc1021P(&tail);
+	CHECK(computeCrc(&bb, 2, 2 + (wordNum - 18) * 4) == tail);
+}
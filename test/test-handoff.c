@@ -0,0 +1,165 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Runs the lock free handoff with its producer and consumer on separate threads: one thread adds packets to a queue
+ * a few bytes at a time, with junk between some of them, and frames them, while the other parses them.
+ * Checks that every packet is parsed once, in order and intact, and that the junk is counted and freed
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-receiver.h>
+#include <blueberry-message.h>
+#include <byteQ.h>
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define TEST_MODULE (5)
+#define QUEUE_SIZE (1000)//not a power of two, so the packets wrap at odd places
+#define PACKET_NUM (100000)
+#define JUNK_EVERY (7)//every this many packets has some junk before it
+#define JUNK_LENGTH (3)
+#define TIME_LIMIT (60)//seconds before the test gives up on a stuck handoff
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint8_t m_inMem[QUEUE_SIZE];
+static uint8_t m_outMem[QUEUE_SIZE];
+static ByteQ m_inQ;
+static ByteQ m_outQ;
+static BbHandoff m_handoff;
+static BbContext m_ctx;
+static uint32_t m_next = 0;//the number of the next packet expected by the consumer
+static uint32_t m_badMessages = 0;
+static time_t m_deadline;
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static void* produce(void* arg);
+static void parseNumbered(Bb* bb, BbBlock msg);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	initBbParser();
+	initBbContext(&m_ctx);
+	registerBbParserCtx(&m_ctx, MAKE_TEST_KEY(TEST_MODULE, 0), parseNumbered);
+	initByteQ(&m_inQ, m_inMem, QUEUE_SIZE);
+	initByteQ(&m_outQ, m_outMem, QUEUE_SIZE);
+	initBbHandoff(&m_handoff, &m_inQ);
+	m_deadline = time(NULL) + TIME_LIMIT;
+
+	pthread_t producer;
+	CHECK(pthread_create(&producer, NULL, produce, NULL) == 0);
+	//this thread is the consumer
+	while(m_next < PACKET_NUM && time(NULL) < m_deadline){
+		if(!processBbHandoff(&m_ctx, &m_handoff, &m_outQ)){
+			sched_yield();
+		}
+	}
+	pthread_join(producer, NULL);
+	//free the junk after the last packet
+	processBbHandoff(&m_ctx, &m_handoff, &m_outQ);
+
+	BbLinkCounts counts;
+	getBbLinkCounts(&m_handoff.link, &counts);
+	CHECK(m_next == PACKET_NUM);
+	CHECK(m_badMessages == 0);
+	CHECK(counts.packets == PACKET_NUM);
+	CHECK(counts.bytesDiscarded == (PACKET_NUM + JUNK_EVERY - 1)/JUNK_EVERY*JUNK_LENGTH);
+	CHECK(counts.crcFailures == 0);
+	CHECK(!isByteQNotEmpty(&m_inQ));
+	CHECK(!isByteQNotEmpty(&m_outQ));//nothing is registered to respond
+	return finishBbTest("test-handoff");
+}
+
+/**
+ * the producer: adds numbered packets of varying lengths to the queue in chunks of varying sizes, framing after each chunk,
+ * and waits for the consumer whenever the queue is full
+ * @param arg - unused
+ * @return NULL
+ */
+static void* produce(void* arg){
+	(void)arg;
+	uint8_t packet[256];
+	uint32_t x = 1;
+	for(uint32_t p = 0; p < PACKET_NUM; ++p){
+		x = x*1103515245u + 12345u;
+		uint32_t len = 0;
+		if(p % JUNK_EVERY == 0){
+			for(uint32_t j = 0; j < JUNK_LENGTH; ++j){
+				packet[len++] = (uint8_t)(0x42 + j);//the first byte of the preamble, among others
+			}
+		}
+		Bb bb;
+		initBbTestBuffer(&bb, packet + len, sizeof(packet) - len, 0);
+		startBbPacket(&bb);
+		BbBlock msg = (BbBlock)bb.length;
+		addBbTestMessage(&bb, MAKE_TEST_KEY(TEST_MODULE, 0), 12 + ((x >> 8) % 32)*4);
+		setBbUint32(&bb, msg, 8, p);
+		finishBbPacket(&bb);
+		len += bb.length;
+
+		uint32_t chunk = 1 + (x >> 16) % 64;
+		for(uint32_t sent = 0; sent < len && time(NULL) < m_deadline;){
+			uint32_t n = len - sent < chunk ? len - sent : chunk;
+			uint32_t added = addBytesToByteQ(&m_inQ, packet + sent, n);
+			sent += added;
+			frameBbHandoff(&m_handoff, 0xffffffff);
+			if(added < n){
+				sched_yield();//the queue is full, so let the consumer catch up
+			}
+		}
+	}
+	//the handoff may have been full when the last packets arrived
+	while(atomic_load(&m_handoff.head) < PACKET_NUM && time(NULL) < m_deadline){
+		frameBbHandoff(&m_handoff, 0xffffffff);
+		sched_yield();
+	}
+	return NULL;
+}
+
+/**
+ * checks that the messages arrive in order and intact
+ */
+static void parseNumbered(Bb* bb, BbBlock msg){
+	uint32_t key = getBbMessageKey(bb, msg);
+	if(getBbUint32(bb, msg, 8) != m_next){
+		++m_badMessages;
+	}
+	++m_next;
+	uint32_t len = getBbMessageLength(bb, msg);
+	for(uint32_t i = 12; i < len; i += 4){
+		if(getBbUint32(bb, msg, (BbBlock)i) != key*0x9e3779b1u + i){
+			++m_badMessages;
+		}
+	}
+}
@@ -0,0 +1,211 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Round trips packets made with BB_LARGE_PACKETS. A packet built in a buffer of 64KB or more is a "BluE" packet,
+ * whose sequence and string placeholders hold offsets in words, so they can point past 64KB.
+ * The bytes of the packet are checked against the layout, then it is received a chunk at a time from a queue that wraps
+ * and parsed back. A packet built in a smaller buffer must still be a normal packet with offsets in bytes
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-receiver.h>
+#include <blueberry-message.h>
+#include <byteQ.h>
+
+#if !BB_LARGE_PACKETS
+#error "test-large must be built with BB_LARGE_PACKETS"
+#endif
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define TEST_KEY MAKE_TEST_KEY(9, 0)
+#define RING_SIZE (200000)//big enough for a large packet, and not a power of two
+#define SMALL_RING_SIZE (4096)
+#define CHUNK (4096)
+#define BYTE_NUM (70000)//enough bytes to push the fields after them past 64KB
+#define WORD_NUM (1000)
+#define TEST_STRING "past 64KB"
+//the message: a sequence of bytes, then a sequence of words, then a string
+#define BYTES_INDEX (8)
+#define WORDS_INDEX (12)
+#define STRING_INDEX (16)
+#define MESSAGE_HEADER_LENGTH (20)
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint8_t m_ring[RING_SIZE];
+static uint8_t m_inMem[RING_SIZE];
+static uint8_t m_outMem[SMALL_RING_SIZE];
+static uint8_t m_packet[RING_SIZE];
+static uint8_t m_bytes[BYTE_NUM];
+static uint32_t m_words[WORD_NUM];
+static BbContext m_ctx;
+static uint32_t m_parsed = 0;
+static uint32_t m_byteNum = 0;//the sequence lengths the test message was built with
+static uint32_t m_wordNum = 0;
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static uint32_t buildTestMessage(Bb* bb, uint32_t byteNum, uint32_t wordNum);
+static void testLargePacket(void);
+static void testSmallPacket(void);
+static void roundTrip(Bb* bb, uint32_t front);
+static void parseLarge(Bb* bb, BbBlock msg);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	initBbParser();
+	initBbContext(&m_ctx);
+	registerBbParserCtx(&m_ctx, TEST_KEY, parseLarge);
+	testLargePacket();
+	testSmallPacket();
+	return finishBbTest("test-large");
+}
+
+/**
+ * builds a large packet that wraps round the end of its ring, checks its bytes and round trips it
+ */
+static void testLargePacket(void){
+	Bb bb;
+	initBbTestBuffer(&bb, m_ring, RING_SIZE, RING_SIZE - 1000);
+	uint32_t len = buildTestMessage(&bb, BYTE_NUM, WORD_NUM);
+	CHECK(isBbPacketLarge(&bb));
+
+	//the preamble reads "BluE"
+	CHECK(getBbUint8(&bb, 0, 0) == 'B');
+	CHECK(getBbUint8(&bb, 0, 1) == 'l');
+	CHECK(getBbUint8(&bb, 0, 2) == 'u');
+	CHECK(getBbUint8(&bb, 0, 3) == 'E');
+	CHECK(getBbUint16(&bb, 0, 4) == len/4);
+	//the placeholders hold the offsets of their blocks from the message in words, and the element lengths in bytes
+	uint32_t bytesBlock = MESSAGE_HEADER_LENGTH;
+	uint32_t wordsBlock = bytesBlock + ((4 + BYTE_NUM + 3) & ~3u);
+	uint32_t stringBlock = wordsBlock + 4 + WORD_NUM*4;
+	CHECK(wordsBlock > 0xffff);
+	CHECK(getBbUint16(&bb, 8, BYTES_INDEX) == bytesBlock/4);
+	CHECK(getBbUint16(&bb, 8, BYTES_INDEX + 2) == 1);
+	CHECK(getBbUint16(&bb, 8, WORDS_INDEX) == wordsBlock/4);
+	CHECK(getBbUint16(&bb, 8, WORDS_INDEX + 2) == 4);
+	CHECK(getBbUint16(&bb, 8, STRING_INDEX) == stringBlock/4);
+	CHECK(getBbUint32(&bb, 8, bytesBlock) == BYTE_NUM);
+	CHECK(getBbUint32(&bb, 8, wordsBlock) == WORD_NUM);
+	CHECK(getBbUint32(&bb, 8, stringBlock) == sizeof(TEST_STRING) - 1);
+	CHECK(getBbUint16(&bb, 8, 4)*4u == len - 8);
+	//the accessors follow the word offsets to the right bytes
+	CHECK(getBbUint32(&bb, 8, getBbSequenceElementIndex(&bb, 8, WORDS_INDEX, 7)) == 7*0x9e3779b1u);
+	CHECK(getBbUint8(&bb, 8, getBbSequenceElementIndex(&bb, 8, BYTES_INDEX, BYTE_NUM - 1)) == (uint8_t)((BYTE_NUM - 1)*7));
+
+	roundTrip(&bb, 0);
+	roundTrip(&bb, RING_SIZE - 5000);//the packet wraps round the end of the queue
+}
+
+/**
+ * checks that a packet built in a buffer smaller than 64KB is a normal packet, with its offsets in bytes
+ */
+static void testSmallPacket(void){
+	static uint8_t small[SMALL_RING_SIZE];
+	Bb bb;
+	initBbTestBuffer(&bb, small, SMALL_RING_SIZE, SMALL_RING_SIZE - 100);
+	uint32_t len = buildTestMessage(&bb, 50, 20);
+	CHECK(!isBbPacketLarge(&bb));
+	CHECK(getBbUint32(&bb, 0, 0) == 0x65756c42);
+	CHECK(getBbUint16(&bb, 0, 4) == len/4);
+	CHECK(getBbUint16(&bb, 8, BYTES_INDEX) == MESSAGE_HEADER_LENGTH);
+	CHECK(getBbUint16(&bb, 8, WORDS_INDEX) == MESSAGE_HEADER_LENGTH + 4 + 52);
+	roundTrip(&bb, RING_SIZE - 100);
+}
+
+/**
+ * builds a packet of one message, with the sequences and string filled with patterns
+ * @param bb - the buffer to build in, with its start set
+ * @param byteNum - the number of elements of the sequence of bytes
+ * @param wordNum - the number of elements of the sequence of words
+ * @return the length of the packet
+ */
+static uint32_t buildTestMessage(Bb* bb, uint32_t byteNum, uint32_t wordNum){
+	for(uint32_t k = 0; k < byteNum; ++k){
+		m_bytes[k] = (uint8_t)(k*7);
+	}
+	for(uint32_t k = 0; k < wordNum; ++k){
+		m_words[k] = k*0x9e3779b1u;
+	}
+	m_byteNum = byteNum;
+	m_wordNum = wordNum;
+	BbBlock msg = startBbPacket(bb);
+	bb->length += MESSAGE_HEADER_LENGTH;
+	updateBbLinear(bb);
+	setBbUint32(bb, msg, 0, TEST_KEY);
+	setBbUint8(bb, msg, 6, 3);
+	initBbSequence(bb, msg, BYTES_INDEX, 1, byteNum);
+	initBbSequence(bb, msg, WORDS_INDEX, 4, wordNum);
+	CHECK(copyBbStringToMessage(bb, msg, STRING_INDEX, TEST_STRING, sizeof(TEST_STRING)) == sizeof(TEST_STRING) - 1);
+	updateBbLinear(bb);
+	CHECK(setBbSequenceUint8s(bb, msg, BYTES_INDEX, 0, m_bytes, byteNum) == byteNum);
+	CHECK(setBbSequenceUint32s(bb, msg, WORDS_INDEX, 0, m_words, wordNum) == wordNum);
+	finishBbPacket(bb);
+	return bb->length;
+}
+
+/**
+ * receives a packet a chunk at a time from a queue and checks that it is parsed once
+ * @param bb - the packet
+ * @param front - where the packet starts in the queue
+ */
+static void roundTrip(Bb* bb, uint32_t front){
+	ByteQ inQ = {m_inMem, RING_SIZE, front, front};
+	ByteQ outQ = {m_outMem, SMALL_RING_SIZE, 0, 0};
+	Bb inP;
+	memset(&inP, 0, sizeof(inP));
+	getBbBytes(bb, 0, 0, m_packet, bb->length);
+	CHECK(addBytesToByteQ(&inQ, m_packet, bb->length) == bb->length);
+	uint32_t before = m_parsed;
+	for(uint32_t c = 0; c < 1000 && isByteQNotEmpty(&inQ); ++c){
+		transceiveBrPacketNCtx(&m_ctx, &inP, &inQ, &outQ, CHUNK);
+	}
+	CHECK(m_parsed - before == 1);
+	CHECK(!isByteQNotEmpty(&inQ));
+}
+
+/**
+ * reads back the test message and checks it against the patterns it was built with
+ */
+static void parseLarge(Bb* bb, BbBlock msg){
+	static uint8_t bytes[BYTE_NUM];
+	static uint32_t words[WORD_NUM];
+	char s[32];
+	++m_parsed;
+	CHECK(getBbSequenceElementNum(bb, msg, BYTES_INDEX) == m_byteNum);
+	CHECK(getBbSequenceElementNum(bb, msg, WORDS_INDEX) == m_wordNum);
+	CHECK(getBbSequenceUint8s(bb, msg, BYTES_INDEX, 0, bytes, BYTE_NUM) == m_byteNum);
+	CHECK(getBbSequenceUint32s(bb, msg, WORDS_INDEX, 0, words, WORD_NUM) == m_wordNum);
+	CHECK(memcmp(bytes, m_bytes, m_byteNum) == 0);
+	CHECK(memcmp(words, m_words, m_wordNum*4) == 0);
+	CHECK(copyBbStringFromMessage(bb, msg, STRING_INDEX, s, sizeof(s) - 1) == sizeof(TEST_STRING) - 1);
+	CHECK(strcmp(s, TEST_STRING) == 0);
+}
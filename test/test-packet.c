@@ -0,0 +1,450 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Round trips packets through the byte queue receiver: packets are built, received a few bytes at a time from a
+ * queue that wraps, parsed, and answered with a response that is received back in turn.
+ * The same is done with queues in mirrored rings, whose packets never wrap.
+ * Also checks that a response is kept within the free space of a queue that is nearly full
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-receiver.h>
+#include <blueberry-message.h>
+#include <blueberry-ring.h>
+#include <byteQ.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define TEST_MODULE (3)
+#define TEST_KEY_NUM (8)
+#define RESPONSE_KEY MAKE_TEST_KEY(TEST_MODULE, 0)
+#define QUEUE_SIZE (1000)//not a power of two, so the packets wrap at odd places
+#define BIG_KEY_NUM (4)
+#define BIG_LENGTH (100)
+#define SMALL_QUEUE_SIZE (300)
+#define RING_SIZE (4096)
+//*******************************************************************************************
+//Types
+//*******************************************************************************************
+/**
+ * the queues of a link and the packets being received from them
+ */
+typedef struct {
+	ByteQ inQ;
+	ByteQ outQ;
+	Bb inP;
+	Bb peerP;
+} TestLink;
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint32_t m_parsed[TEST_KEY_NUM];
+static uint32_t m_badMessages = 0;
+static BbContext m_ctx;
+static BbContext m_peer;
+static BbContext m_big;
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static void parseTest(Bb* bb, BbBlock msg);
+static void buildResponse(Bb* bb, BbBlock msg);
+static void buildBig(Bb* bb, BbBlock msg);
+static void buildRunaway(Bb* bb, BbBlock msg);
+static void build60(Bb* bb, BbBlock msg);
+static void build52(Bb* bb, BbBlock msg);
+static void build40(Bb* bb, BbBlock msg);
+static void testRandomReceive(TestLink* link, uint32_t packetNum);
+static void testReceive(TestLink* link, uint32_t messageNum, uint32_t messageLength, uint32_t junk, uint32_t chunk, bool corrupt);
+static void testMirroredRings(void);
+static void testRunawayBuilder(void);
+static void testPartialPacking(void);
+static void testUnsentDropped(void);
+static bool refuseNextBuffer(Bb* bb, void* context);
+static void testBuilderTable(void);
+static void testResponseOverflow(uint32_t front);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	initBbParser();
+	initBbContext(&m_ctx);
+	initBbContext(&m_peer);
+	for(uint32_t k = 0; k < TEST_KEY_NUM; ++k){
+		registerBbParserCtx(&m_ctx, MAKE_TEST_KEY(TEST_MODULE, k), parseTest);
+		registerBbParserCtx(&m_peer, MAKE_TEST_KEY(TEST_MODULE, k), parseTest);
+	}
+	registerBbBuilderCtx(&m_ctx, RESPONSE_KEY, buildResponse);
+
+	static uint8_t inMem[QUEUE_SIZE];
+	static uint8_t outMem[QUEUE_SIZE];
+	static TestLink link;
+	link.inQ = (ByteQ){inMem, QUEUE_SIZE, 0, 0};
+	link.outQ = (ByteQ){outMem, QUEUE_SIZE, 0, 0};
+	testRandomReceive(&link, 2000);
+	testMirroredRings();
+	CHECK(m_badMessages == 0);
+
+	initBbContext(&m_big);
+	for(uint32_t k = 0; k < BIG_KEY_NUM; ++k){
+		registerBbBuilderCtx(&m_big, MAKE_TEST_KEY(TEST_MODULE, k), buildBig);
+	}
+	testResponseOverflow(0);//the free space doesn't wrap
+	testResponseOverflow(100);//the free space wraps round the end of the queue
+	testRunawayBuilder();
+	testPartialPacking();
+	testUnsentDropped();
+	testBuilderTable();
+	return finishBbTest("test-packet");
+}
+
+/**
+ * receives packets of random sizes, some after junk and some corrupt, over a link
+ * @param link - the queues to send the packets through
+ * @param packetNum - the number of packets
+ */
+static void testRandomReceive(TestLink* link, uint32_t packetNum){
+	uint32_t x = 1;
+	for(uint32_t iter = 0; iter < packetNum; ++iter){
+		x = x*1103515245u + 12345u;
+		uint32_t messageNum = 1 + (x >> 8) % 5;
+		uint32_t messageLength = 12 + ((x >> 12) % 8)*4;
+		uint32_t junk = (x >> 16) % 4 == 0 ? (x >> 20) % 7 : 0;
+		uint32_t chunk = 1 + (x >> 4) % 40;
+		bool corrupt = (x >> 24) % 4 == 0;
+		testReceive(link, messageNum, messageLength, junk, chunk, corrupt);
+	}
+}
+
+/**
+ * receives one packet, after some junk, a chunk at a time and checks that it is parsed and answered only if it is good
+ */
+static void testReceive(TestLink* link, uint32_t messageNum, uint32_t messageLength, uint32_t junk, uint32_t chunk, bool corrupt){
+	ByteQ* inQ = &link->inQ;
+	ByteQ* outQ = &link->outQ;
+	uint8_t packet[256];
+	Bb bb;
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	uint32_t len = makeBbTestPacket(&bb, MAKE_TEST_KEY(TEST_MODULE, 0), messageNum, messageLength);
+	if(corrupt){
+		packet[len - 1] ^= 0x10;
+	}
+	for(uint32_t j = 0; j < junk; ++j){
+		uint8_t b = (uint8_t)(0x42 + j);//the first byte of the preamble, among others
+		addBytesToByteQ(inQ, &b, 1);
+	}
+	CHECK(addBytesToByteQ(inQ, packet, len) == len);
+
+	uint32_t before[TEST_KEY_NUM];
+	memcpy(before, m_parsed, sizeof(before));
+	for(uint32_t c = 0; c < 1000 && isByteQNotEmpty(inQ); ++c){
+		transceiveBrPacketNCtx(&m_ctx, &link->inP, inQ, outQ, chunk);
+	}
+	for(uint32_t k = 0; k < messageNum; ++k){
+		CHECK(m_parsed[k] - before[k] == (corrupt ? 0u : 1u));
+	}
+
+	//the response goes back the other way
+	uint32_t response = getBytesUsed(outQ);
+	CHECK(response == (corrupt ? 0u : 20u));
+	memcpy(before, m_parsed, sizeof(before));
+	while(isByteQNotEmpty(outQ)){
+		if(!transceiveBrPacketNCtx(&m_peer, &link->peerP, outQ, inQ, 0xffffffff)){
+			break;
+		}
+	}
+	CHECK(!isByteQNotEmpty(outQ));
+	CHECK(m_parsed[0] - before[0] == (corrupt ? 0u : 1u));
+}
+
+/**
+ * runs packets through queues in mirrored rings, so that no packet wraps, and checks that a queue that uses only part
+ * of a ring isn't treated as mirrored
+ */
+static void testMirroredRings(void){
+	BbRing in;
+	BbRing out;
+	CHECK(openBbRing(&in, RING_SIZE));
+	CHECK(openBbRing(&out, RING_SIZE));
+	CHECK(getBbRingMirror(in.buffer, in.size) == (in.mirrored ? in.size : 0u));
+	CHECK(getBbRingMirror(in.buffer, in.size - 4) == 0);
+
+	TestLink link;
+	memset(&link, 0, sizeof(link));
+	link.inQ = (ByteQ){in.buffer, in.size, 0, 0};
+	link.outQ = (ByteQ){out.buffer, out.size, 0, 0};
+	testRandomReceive(&link, 500);
+
+	//a queue shorter than the ring wraps at its own end, not at the mirror
+	memset(&link, 0, sizeof(link));
+	link.inQ = (ByteQ){in.buffer, in.size - 4, 0, 0};
+	link.outQ = (ByteQ){out.buffer, out.size - 4, 0, 0};
+	testRandomReceive(&link, 500);
+
+	closeBbRing(&in);
+	closeBbRing(&out);
+}
+
+/**
+ * checks that a message whose length would round up to 64 kB is dropped rather than taken to fit, as it would be if the
+ * length were rounded in 16 bits
+ */
+static void testRunawayBuilder(void){
+	static BbContext ctx;
+	uint8_t packet[256];
+	Bb bb;
+	initBbContext(&ctx);
+	registerBbBuilderCtx(&ctx, RESPONSE_KEY, buildRunaway);
+	registerBbBuilderCtx(&ctx, RESPONSE_KEY + 1, buildResponse);
+	queueBbMessageCtx(&ctx, RESPONSE_KEY);
+	queueBbMessageCtx(&ctx, RESPONSE_KEY + 1);
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	CHECK(makeBbPacketsWithQueuedMessagesCtx(&ctx, &bb, NULL, NULL) == 1);
+	CHECK(bb.length == 8 + 12);//just the message that fits
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+}
+
+/**
+ * checks that messages are packed for the room that the first packet really has, rather than for the whole buffer.
+ * Only 100 bytes of the buffer may be used, so the 60 and 40 byte messages go first and the 52 byte one waits
+ */
+static void testPartialPacking(void){
+	if(PACK_NUM < 3){
+		return;//packing is left out, or can't take all three messages
+	}
+	static BbContext ctx;
+	uint8_t packet[1000];
+	Bb bb;
+	initBbContext(&ctx);
+	registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60), build60);
+	registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52), build52);
+	registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 40), build40);
+	setBbBuilderSizeHintCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60), 60, NULL);
+	setBbBuilderSizeHintCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52), 52, NULL);
+	setBbBuilderSizeHintCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 40), 40, NULL);
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 40));
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	makeBbPacketWithQueuedMessagesNCtx(&ctx, &bb, 8 + 100);
+	CHECK(bb.length == 8 + 100);
+	CHECK(isBbPacketRequestedCtx(&ctx));
+
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	makeBbPacketWithQueuedMessagesNCtx(&ctx, &bb, sizeof(packet));
+	CHECK(bb.length == 8 + 52);
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+}
+
+/**
+ * checks that messages that don't fit in a response are dropped rather than left for whoever makes the next request,
+ * both with no next() and with a next() that has no buffer to give
+ */
+static void testUnsentDropped(void){
+	static BbContext ctx;
+	uint8_t packet[8 + 100];
+	Bb bb;
+	initBbContext(&ctx);
+	registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60), build60);
+	registerBbBuilderCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52), build52);
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52));
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	makeBbPacketWithQueuedMessagesCtx(&ctx, &bb);
+	CHECK(bb.length == 8 + 60);
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 60));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 52));
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	CHECK(makeBbPacketsWithQueuedMessagesCtx(&ctx, &bb, refuseNextBuffer, NULL) == 1);
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+}
+
+/**
+ * a next() for testUnsentDropped() that has no buffer to give
+ */
+static bool refuseNextBuffer(Bb* bb, void* context){
+	(void)bb;
+	(void)context;
+	return false;
+}
+
+/**
+ * queues messages from a constant builder table, with the default BUILDER_TABLE_NUM, and checks that a table too long
+ * for the pending slots is reported and cut short rather than having its last entries silently never queued
+ */
+static void testBuilderTable(void){
+	if(BUILDER_TABLE_NUM < 2){
+		return;//the build doesn't queue from tables
+	}
+	static const BbProcessorEntry table[] = {
+		{RESPONSE_KEY, buildResponse, 12, NULL},
+		{MAKE_TEST_KEY(TEST_MODULE, 40), build40, 40, NULL},
+	};
+	static BbProcessorEntry longTable[BUILDER_TABLE_NUM + 1];
+	static BbContext ctx;
+	uint8_t packet[256];
+	Bb bb;
+	initBbContext(&ctx);
+	CHECK(setBbBuilderTableCtx(&ctx, table, 2));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 40));
+	queueBbMessageCtx(&ctx, RESPONSE_KEY);
+	CHECK(isBbPacketRequestedCtx(&ctx));
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	CHECK(makeBbPacketsWithQueuedMessagesCtx(&ctx, &bb, NULL, NULL) == 1);
+	CHECK(bb.length == 8 + 40 + 12);
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+
+	for(uint32_t k = 0; k < BUILDER_TABLE_NUM + 1; ++k){
+		longTable[k] = (BbProcessorEntry){MAKE_TEST_KEY(TEST_MODULE, 100 + k), buildResponse, 12, NULL};
+	}
+	CHECK(!setBbBuilderTableCtx(&ctx, longTable, BUILDER_TABLE_NUM + 1));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 100 + BUILDER_TABLE_NUM));//past the end, so there is no builder
+	CHECK(!isBbPacketRequestedCtx(&ctx));
+	queueBbMessageCtx(&ctx, MAKE_TEST_KEY(TEST_MODULE, 100 + BUILDER_TABLE_NUM - 1));
+	CHECK(isBbPacketRequestedCtx(&ctx));
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	CHECK(makeBbPacketsWithQueuedMessagesCtx(&ctx, &bb, NULL, NULL) == 1);
+	CHECK(bb.length == 8 + 12);
+}
+
+/**
+ * answers a request for four big messages with a queue that only has room for one, and checks that the response is kept
+ * within the free space, that the overflow is counted and that the rest are sent in later responses as the queue empties
+ * @param front - where the unsent bytes start in the queue
+ */
+static void testResponseOverflow(uint32_t front){
+	static uint8_t inMem[QUEUE_SIZE];
+	static uint8_t outMem[SMALL_QUEUE_SIZE];
+	ByteQ inQ = {inMem, QUEUE_SIZE, 0, 0};
+	ByteQ outQ = {outMem, SMALL_QUEUE_SIZE, front, front};
+	Bb inP;
+	memset(&inP, 0, sizeof(inP));
+	uint8_t packet[256];
+	Bb bb;
+	BbLinkCounts before;
+	BbLinkCounts after;
+	getBbLinkCounts(getBbLinkStats(&m_big), &before);
+
+	//half the queue has bytes waiting to be sent
+	memset(outMem, 0xa5, sizeof(outMem));
+	advanceByteQBack(&outQ, SMALL_QUEUE_SIZE/2);
+
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	uint32_t len = makeBbTestPacket(&bb, MAKE_TEST_KEY(TEST_MODULE, 0), BIG_KEY_NUM, 12);
+	addBytesToByteQ(&inQ, packet, len);
+	CHECK(transceiveBrPacketNCtx(&m_big, &inP, &inQ, &outQ, QUEUE_SIZE));
+
+	uint32_t used = getBytesUsed(&outQ);
+	CHECK(used == SMALL_QUEUE_SIZE/2 + 8 + BIG_LENGTH);
+	//the response was kept within the free space, even where that wraps, so the bytes waiting to be sent weren't touched
+	for(uint32_t i = 0; i < SMALL_QUEUE_SIZE/2; ++i){
+		CHECK(outMem[(front + i) % SMALL_QUEUE_SIZE] == 0xa5);
+	}
+	getBbLinkCounts(getBbLinkStats(&m_big), &after);
+	CHECK(after.txOverflows == before.txOverflows + 1);
+	CHECK(isBbPacketRequestedCtx(&m_big));
+
+	//as the queue is sent, the next responses have the rest. They are triggered by a packet that requests nothing more
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	len = makeBbTestPacket(&bb, MAKE_TEST_KEY(TEST_MODULE + 1, 0), 1, 12);
+	uint32_t sent = (used - SMALL_QUEUE_SIZE/2 - 8)/BIG_LENGTH;
+	for(uint32_t r = 0; r < 4 && isBbPacketRequestedCtx(&m_big); ++r){
+		discardFromByteQ(&outQ, getBytesUsed(&outQ));
+		addBytesToByteQ(&inQ, packet, len);
+		CHECK(transceiveBrPacketNCtx(&m_big, &inP, &inQ, &outQ, QUEUE_SIZE));
+		sent += (getBytesUsed(&outQ) - 8)/BIG_LENGTH;
+	}
+	CHECK(sent == BIG_KEY_NUM);
+	CHECK(!isBbPacketRequestedCtx(&m_big));
+}
+
+/**
+ * counts the messages parsed for each key and checks their contents
+ */
+static void parseTest(Bb* bb, BbBlock msg){
+	uint32_t key = getBbMessageKey(bb, msg);
+	uint32_t k = key & 0xffff;
+	if(k < TEST_KEY_NUM){
+		++m_parsed[k];
+	}
+	uint32_t len = getBbMessageLength(bb, msg);
+	for(uint32_t i = 8; i < len; i += 4){
+		if(getBbUint32(bb, msg, (BbBlock)i) != key*0x9e3779b1u + i){
+			++m_badMessages;
+		}
+	}
+}
+
+/**
+ * builds a big message with the key of the next one queued
+ */
+static void buildBig(Bb* bb, BbBlock msg){
+	static uint32_t k = 0;
+	addBbTestMessage(bb, MAKE_TEST_KEY(TEST_MODULE, k++ % BIG_KEY_NUM), BIG_LENGTH);
+	(void)msg;
+}
+
+/**
+ * builds a message whose length runs to just short of 64 kB, far past the end of the buffer
+ */
+static void buildRunaway(Bb* bb, BbBlock msg){
+	bb->length = (uint32_t)msg + 0xfff6;
+}
+
+/**
+ * builds a 60 byte message for testPartialPacking()
+ */
+static void build60(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, MAKE_TEST_KEY(TEST_MODULE, 60), 60);
+	(void)msg;
+}
+
+/**
+ * builds a 52 byte message for testPartialPacking()
+ */
+static void build52(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, MAKE_TEST_KEY(TEST_MODULE, 52), 52);
+	(void)msg;
+}
+
+/**
+ * builds a 40 byte message for testPartialPacking()
+ */
+static void build40(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, MAKE_TEST_KEY(TEST_MODULE, 40), 40);
+	(void)msg;
+}
+
+/**
+ * builds a 12 byte response
+ */
+static void buildResponse(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, RESPONSE_KEY, 12);
+	(void)msg;
+}
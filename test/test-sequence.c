@@ -0,0 +1,134 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Checks the bulk sequence accessors: elements written in bulk read back the same in bulk and one at a time, wherever
+ * the sequence wraps round its ring, and a sequence is only copied as the type it was made with
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-message.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define RING_SIZE (1000)
+#define ELEMENT_NUM (100)
+#define WIDE_INDEX (8)//the placeholder of the 32-bit sequence
+#define NARROW_INDEX (12)//the placeholder of the 16-bit sequence
+#define LONG_ELEMENT_NUM (16400)//enough 32-bit elements for a sequence block past 64 KB
+#define LONG_BUFFER_SIZE (70000)
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint8_t m_ring[RING_SIZE];
+static uint8_t m_longBuffer[LONG_BUFFER_SIZE];
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static void testSequences(uint32_t start);
+static void testLongSequence(void);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	initBbParser();
+	for(uint32_t start = 0; start < RING_SIZE; start += 4){
+		testSequences(start);
+	}
+	testLongSequence();
+	return finishBbTest("test-sequence");
+}
+
+/**
+ * builds a message with a 32-bit and a 16-bit sequence, and reads them back
+ * @param start - where the packet starts in the ring
+ */
+static void testSequences(uint32_t start){
+	uint32_t wide[ELEMENT_NUM];
+	uint16_t narrow[ELEMENT_NUM];
+	for(uint32_t k = 0; k < ELEMENT_NUM; ++k){
+		wide[k] = start * 0x10001u + k * 0x9e3779b1u;
+		narrow[k] = (uint16_t)(start + k * 7);
+	}
+	Bb bb;
+	initBbTestBuffer(&bb, m_ring, RING_SIZE, start);
+	startBbPacket(&bb);
+	BbBlock msg = (BbBlock)bb.length;
+	bb.length += 16;
+	updateBbLinear(&bb);
+	setBbUint32(&bb, msg, 0, MAKE_TEST_KEY(1, 1));
+	setBbUint8(&bb, msg, 6, 2);
+	initBbSequence(&bb, msg, WIDE_INDEX, 4, ELEMENT_NUM);
+	initBbSequence(&bb, msg, NARROW_INDEX, 2, ELEMENT_NUM);
+	CHECK(setBbSequenceUint32s(&bb, msg, WIDE_INDEX, 0, wide, ELEMENT_NUM) == ELEMENT_NUM);
+	CHECK(setBbSequenceUint16s(&bb, msg, NARROW_INDEX, 0, narrow, ELEMENT_NUM) == ELEMENT_NUM);
+	finishBbPacket(&bb);
+
+	//in bulk and one at a time
+	uint32_t wideOut[ELEMENT_NUM];
+	uint16_t narrowOut[ELEMENT_NUM];
+	CHECK(getBbSequenceUint32s(&bb, msg, WIDE_INDEX, 0, wideOut, ELEMENT_NUM) == ELEMENT_NUM);
+	CHECK(getBbSequenceUint16s(&bb, msg, NARROW_INDEX, 0, narrowOut, ELEMENT_NUM) == ELEMENT_NUM);
+	for(uint32_t k = 0; k < ELEMENT_NUM; ++k){
+		CHECK(wideOut[k] == wide[k]);
+		CHECK(narrowOut[k] == narrow[k]);
+		CHECK(getBbUint32(&bb, msg, getBbSequenceElementIndex(&bb, msg, WIDE_INDEX, k)) == wide[k]);
+		CHECK(getBbUint16(&bb, msg, getBbSequenceElementIndex(&bb, msg, NARROW_INDEX, k)) == narrow[k]);
+	}
+
+	//past the end of the sequence only the elements that are there are copied
+	CHECK(getBbSequenceUint32s(&bb, msg, WIDE_INDEX, ELEMENT_NUM - 3, wideOut, 10) == 3);
+	CHECK(wideOut[2] == wide[ELEMENT_NUM - 1]);
+	CHECK(getBbSequenceUint32s(&bb, msg, WIDE_INDEX, ELEMENT_NUM, wideOut, 10) == 0);
+
+	//a sequence is only copied as the type it was made with, so nothing is misread or overrun
+	memset(narrowOut, 0, sizeof(narrowOut));
+	CHECK(getBbSequenceUint16s(&bb, msg, WIDE_INDEX, 0, narrowOut, ELEMENT_NUM) == 0);
+	CHECK(narrowOut[0] == 0);
+	CHECK(getBbSequenceUint32s(&bb, msg, NARROW_INDEX, 0, wideOut, ELEMENT_NUM) == 0);
+	CHECK(setBbSequenceUint32s(&bb, msg, NARROW_INDEX, 0, wide, ELEMENT_NUM) == 0);
+	CHECK(getBbSequenceUint16s(&bb, msg, NARROW_INDEX, 0, narrowOut, ELEMENT_NUM) == ELEMENT_NUM);
+	CHECK(narrowOut[ELEMENT_NUM - 1] == narrow[ELEMENT_NUM - 1]);
+}
+
+/**
+ * makes a sequence whose block is longer than 64 KB, and checks that the packet and message grow by all of it
+ */
+static void testLongSequence(void){
+	Bb bb;
+	initBbTestBuffer(&bb, m_longBuffer, LONG_BUFFER_SIZE, 0);
+	startBbPacket(&bb);
+	BbBlock msg = (BbBlock)bb.length;
+	bb.length += 16;
+	updateBbLinear(&bb);
+	setBbUint32(&bb, msg, 0, MAKE_TEST_KEY(1, 1));
+	uint32_t block = bb.length;
+	initBbSequence(&bb, msg, WIDE_INDEX, 4, LONG_ELEMENT_NUM);
+	CHECK(bb.length == block + 4 + LONG_ELEMENT_NUM*4);
+	CHECK(getBbMessageLength(&bb, msg) == bb.length - msg);
+	CHECK(getBbSequenceElementNum(&bb, msg, WIDE_INDEX) == LONG_ELEMENT_NUM);
+}
@@ -0,0 +1,209 @@
+/*
+Copyright (c) 2026 Blue Robotics North Inc.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+*/
+
+
+/**
+ * Exchanges packets with the UDP host module over the loopback interface
+ * Checks that a request without a response doesn't use up a response buffer, that datagrams too big for a buffer are
+ * counted, and measures the packets per second of a request and response round trip
+ */
+
+//*******************************************************************************************
+//Includes
+//*******************************************************************************************
+#include "bb-test.h"
+
+#include <blueberry-receiver.h>
+#include <blueberry-message.h>
+#include <blueberry-udp-host.h>
+
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+//*******************************************************************************************
+//Defines
+//*******************************************************************************************
+#define ANSWERED_KEY MAKE_TEST_KEY(7, 1)//has a builder, so a request gets a response
+#define UNANSWERED_KEY MAKE_TEST_KEY(7, 2)//only has a parser
+#define ROUND_NUM (2000)
+//*******************************************************************************************
+//Variables
+//*******************************************************************************************
+static uint32_t m_parsed = 0;
+static int m_fd = -1;
+static struct sockaddr_in m_to;
+//*******************************************************************************************
+//Function Prototypes
+//*******************************************************************************************
+static void parseTest(Bb* bb, BbBlock msg);
+static void buildResponse(Bb* bb, BbBlock msg);
+static void sendRequest(uint32_t key, uint32_t length);
+static uint32_t serve(uint32_t expected);
+static uint32_t receiveResponses(uint32_t expected);
+static void testUnanswered(void);
+static void testTruncated(void);
+static void testRate(void);
+//*******************************************************************************************
+//Code
+//*******************************************************************************************
+int main(void){
+	initBbParser();
+	registerBbParser(ANSWERED_KEY, parseTest);
+	registerBbParser(UNANSWERED_KEY, parseTest);
+	registerBbBuilder(ANSWERED_KEY, buildResponse);
+
+	m_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	memset(&m_to, 0, sizeof(m_to));
+	m_to.sin_family = AF_INET;
+	m_to.sin_port = htons(BB_UDP_PORT);
+	m_to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	CHECK(m_fd >= 0);
+
+	testUnanswered();
+	testTruncated();
+	testRate();
+
+	close(m_fd);
+	closeBbUdpHost();
+	return finishBbTest("test-udp-host");
+}
+
+/**
+ * sends many more requests without a response than there are response buffers, then checks that one with a response still gets it
+ */
+static void testUnanswered(void){
+	for(uint32_t i = 0; i < 3*BB_UDP_HOST_BATCH; ++i){
+		sendRequest(UNANSWERED_KEY, 20);
+		CHECK(serve(1) == 1);
+	}
+	CHECK(receiveResponses(0) == 0);
+	sendRequest(ANSWERED_KEY, 20);
+	CHECK(serve(1) == 1);
+	CHECK(receiveResponses(1) == 1);
+}
+
+/**
+ * sends a packet bigger than a receive buffer and checks that it is counted, rather than dropped silently
+ */
+static void testTruncated(void){
+	BbLinkCounts before;
+	BbLinkCounts after;
+	getBbLinkCounts(getBbLinkStats(getBbDefaultContext()), &before);
+	uint32_t truncated = getBbUdpHostTruncatedNum();
+	uint32_t parsed = m_parsed;
+	sendRequest(ANSWERED_KEY, BB_UDP_HOST_MTU + 100);
+	CHECK(serve(1) == 1);
+	getBbLinkCounts(getBbLinkStats(getBbDefaultContext()), &after);
+	CHECK(getBbUdpHostTruncatedNum() == truncated + 1);
+	CHECK(after.truncatedPackets == before.truncatedPackets + 1);
+	CHECK(m_parsed == parsed);
+	CHECK(receiveResponses(0) == 0);
+}
+
+/**
+ * sends requests a batch at a time and measures how many round trips are made each second
+ */
+static void testRate(void){
+	uint32_t sent = 0;
+	uint32_t received = 0;
+	struct timespec t0;
+	struct timespec t1;
+	clock_gettime(CLOCK_MONOTONIC, &t0);
+	for(uint32_t r = 0; r < ROUND_NUM; ++r){
+		for(uint32_t i = 0; i < BB_UDP_HOST_BATCH; ++i){
+			sendRequest(ANSWERED_KEY, 20);
+		}
+		sent += BB_UDP_HOST_BATCH;
+		serve(BB_UDP_HOST_BATCH);
+		received += receiveResponses(BB_UDP_HOST_BATCH);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &t1);
+	double s = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec)*1e-9;
+	printf("%u requests, %u responses in %.3f s, %.0f packets/s\n", sent, received, s, received/s);
+	CHECK(received == sent);
+}
+
+/**
+ * sends a request packet with one message to the host module
+ * @param key - the key of the message
+ * @param length - the length of the packet, at least 16
+ */
+static void sendRequest(uint32_t key, uint32_t length){
+	uint8_t packet[2*BB_UDP_HOST_MTU];
+	Bb bb;
+	initBbTestBuffer(&bb, packet, sizeof(packet), 0);
+	makeBbTestPacket(&bb, key, 1, length - 8);
+	CHECK(sendto(m_fd, packet, bb.length, 0, (struct sockaddr*)&m_to, sizeof(m_to)) == (ssize_t)bb.length);
+}
+
+/**
+ * lets the host module receive and answer requests
+ * @param expected - the number of requests to wait for
+ * @return the number of requests received
+ */
+static uint32_t serve(uint32_t expected){
+	uint32_t result = 0;
+	for(uint32_t i = 0; i < 100 && result < expected; ++i){
+		result += pollBbUdpHost(10);
+	}
+	return result;
+}
+
+/**
+ * reads the responses sent back by the host module
+ * @param expected - the number of responses to wait for. If 0 then only ones already waiting are read
+ * @return the number of responses
+ */
+static uint32_t receiveResponses(uint32_t expected){
+	uint32_t result = 0;
+	uint8_t buffer[BB_UDP_HOST_MTU];
+	struct pollfd p = {m_fd, POLLIN, 0};
+	for(uint32_t i = 0; i < 1000; ++i){
+		if(poll(&p, 1, result < expected ? 10 : 0) <= 0){
+			break;
+		}
+		if(recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT) > 0){
+			++result;
+		}
+	}
+	return result;
+}
+
+/**
+ * counts the messages parsed
+ */
+static void parseTest(Bb* bb, BbBlock msg){
+	(void)bb;
+	(void)msg;
+	++m_parsed;
+}
+
+/**
+ * builds a 12 byte response
+ */
+static void buildResponse(Bb* bb, BbBlock msg){
+	addBbTestMessage(bb, ANSWERED_KEY, 12);
+	(void)msg;
+}